@@ -0,0 +1,833 @@
+#ifndef AVLTREETYPE_H
+#define AVLTREETYPE_H
+
+/* Define an AVL (height-balanced) binary search tree, T, is either empty or
+    1. T is a binary search tree.
+    2. The heights of the left and right subtrees of the root
+    differ by at most one.
+    3. The left and right subtrees of the root are AVL trees.
+   The height of an AVL tree with n nodes is O(log n), so search, insert
+   and deleteNode stay logarithmic even when the items arrive in sorted
+   order.
+*/
+
+#include <iostream>
+#include <vector>
+#include "binaryTreeType.h"
+#include "bSearchTreeType.h"
+
+using namespace std;
+
+template <class elemType, class allocType = nodeAllocator<elemType>,
+          class compareType = less<elemType> >
+class avlTreeType: public bSearchTreeType<elemType, allocType, compareType>
+{
+public:
+    bool insert(const elemType& insertItem);
+    bool insert(elemType&& insertItem);
+    //Function to insert insertItem in the AVL tree.
+    //Postcondition: If there is no node in the AVL tree that
+    // has the same info as insertItem, a node with
+    // the info insertItem is created and inserted in
+    // the tree, and the tree is rebalanced so that it
+    // remains an AVL tree, and true is returned;
+    // otherwise, insertDuplicate is reported and false
+    // is returned. The second version moves
+    // insertItem into the node.
+    template <class... argTypes>
+    bool emplace(argTypes&&... args);
+    //Function to insert an item constructed from args directly
+    //in a new node.
+    //Postcondition: Same as insert; if the item is a duplicate,
+    // the new node is destroyed again.
+    bool deleteNode(const elemType& deleteItem);
+    //Function to delete deleteItem from the AVL tree.
+    //Postcondition: If a node with the same info as
+    // deleteItem is found, it is deleted from the
+    // tree, the tree is rebalanced so that it
+    // remains an AVL tree, and true is returned.
+    // If the tree is empty or deleteItem is not in
+    // the tree, deleteEmptyTree or deleteNotFound
+    // is reported and false is returned.
+    template <class keyType, class compare = compareType,
+              class = typename compare::is_transparent>
+    bool deleteNode(const keyType& key);
+    //Function to delete the item equivalent to key, which does
+    //not have to be an elemType; only available when
+    //compareType is transparent.
+    //Postcondition: Same as above.
+
+    template <class inputIterator>
+    int insertBatch(inputIterator first, inputIterator last);
+    template <class inputIterator>
+    int deleteBatch(inputIterator first, inputIterator last);
+    //Functions to insert or delete the items in [first, last)
+    //in one descent, as in bSearchTreeType. On the way back up,
+    //a node whose subtrees differ in height by two is
+    //rebalanced with rotations; if they differ by more (many
+    //items went into one side), its subtree is relinked into
+    //a perfectly balanced one, reusing the nodes.
+    //Postcondition: Same as in bSearchTreeType; the tree
+    // remains an AVL tree.
+
+    bool split(const elemType& splitItem, avlTreeType<elemType, allocType, compareType>& greaterTree);
+    bool join(avlTreeType<elemType, allocType, compareType>& greaterTree);
+    int unionWith(avlTreeType<elemType, allocType, compareType>& otherTree);
+    int intersectWith(const avlTreeType<elemType, allocType, compareType>& otherTree);
+    int differenceWith(const avlTreeType<elemType, allocType, compareType>& otherTree);
+    //Functions with the same postconditions as in bSearchTreeType,
+    //built on the split and join of AVL trees instead of a
+    //merge: split and join take O(log n) time, and unionWith,
+    //intersectWith and differenceWith, of a tree of n items with
+    //one of m <= n items, O(m log(n/m + 1)). The set operations
+    //split this tree at the root of otherTree (for unionWith,
+    //otherTree at the root of this tree) and work on the two
+    //halves, which do not share nodes, in parallel if they are
+    //larger than the cutoff of treeParallelism.h, more than one
+    //thread may be used and the allocator is threadSafe.
+    //Postcondition: The trees remain AVL trees.
+
+    using bSearchTreeType<elemType, allocType, compareType>::bSearchTreeType;
+    //The range constructor of bSearchTreeType builds a
+    //perfectly balanced tree, which is also an AVL tree; the
+    //comparator constructor is inherited as well.
+
+private:
+    template <class itemType>
+    bool insertIntoAVL(nodeType<elemType>* &p, itemType&& insertItem);
+    //Function to insert insertItem in the AVL tree to which
+    //p points.
+    //Postcondition: Returns true if a node was inserted;
+    // every node on the path from p to the new node
+    // is rebalanced.
+
+    bool linkIntoAVL(nodeType<elemType>* &p, nodeType<elemType> *newNode);
+    //Function to link the node newNode into the AVL tree to
+    //which p points.
+    //Postcondition: Same as insertIntoAVL; newNode is left
+    // untouched if its info is already in the tree.
+
+    template <class keyType>
+    bool deleteKey(const keyType& deleteItem);
+    //Function to do deleteNode for an item or a key.
+
+    template <class keyType>
+    bool deleteFromAVL(nodeType<elemType>* &p, const keyType& deleteItem);
+    //Function to delete deleteItem from the AVL tree to which
+    //p points.
+    //Postcondition: Returns true if a node was deleted;
+    // every node on the path from p to the deleted
+    // node is rebalanced.
+
+    void mergeIntoAVL(nodeType<elemType>* &p, vector<elemType>& items,
+                      size_t first, size_t last);
+    //Function to insert the sorted items[first..last-1] in the
+    //AVL tree to which p points.
+    //Postcondition: Every node on the way is rebalanced.
+
+    void deleteBatchFromAVL(nodeType<elemType>* &p, const vector<elemType>& items,
+                            size_t first, size_t last);
+    //Function to delete the sorted items[first..last-1] from
+    //the AVL tree to which p points.
+    //Postcondition: Every node on the way is rebalanced.
+
+    void restoreBalance(nodeType<elemType>* &p);
+    //Function to restore the AVL property at p when both
+    //subtrees of p are AVL trees of any heights.
+    //Postcondition: The subtree to which p points is an AVL
+    // tree.
+
+    void rebuildSubtree(nodeType<elemType>* &p);
+    //Postcondition: The nodes of the subtree to which p points
+    // are relinked into a perfectly balanced tree;
+    // p points to its root.
+
+    nodeType<elemType>* joinAVL(nodeType<elemType> *lTree, nodeType<elemType> *middle,
+                                nodeType<elemType> *rTree);
+    //Function to join the AVL trees lTree and rTree with the
+    //node middle, whose item lies between theirs. Takes time
+    //proportional to the difference of their heights.
+    //Postcondition: Returns the root of the AVL tree of all
+    // their nodes.
+
+    nodeType<elemType>* joinAVL(nodeType<elemType> *lTree, nodeType<elemType> *rTree);
+    //Function to join the AVL trees lTree and rTree, every item
+    //of lTree being less than those of rTree.
+    //Postcondition: Same as above.
+
+    void splitAVL(nodeType<elemType> *p, const elemType& splitItem, nodeType<elemType>* &lTree,
+                  nodeType<elemType>* &middle, nodeType<elemType>* &rTree);
+    //Function to split the AVL tree to which p points at
+    //splitItem.
+    //Postcondition: lTree and rTree are AVL trees of the nodes
+    // less and greater than splitItem; middle is the
+    // node equivalent to splitItem, or nullptr.
+
+    nodeType<elemType>* unionAVL(nodeType<elemType> *p, nodeType<elemType> *q, int spawn);
+    //Function to merge the AVL trees to which p and q point;
+    //of two equivalent nodes, the one of q is deallocated.
+    //Postcondition: Returns the root of the merged AVL tree.
+
+    nodeType<elemType>* filterAVL(nodeType<elemType> *p, nodeType<elemType> *q,
+                                  bool keepCommon, int spawn);
+    //Function to keep the nodes of the AVL tree to which p
+    //points whose items are (keepCommon) or are not in the tree
+    //to which q points, which is not changed.
+    //Postcondition: Returns the root of the AVL tree of the
+    // nodes kept; the others are deallocated.
+    //spawn is the number of levels of the recursion that may
+    //still run their two halves in parallel.
+
+    int parallelDepth() const;
+    //Postcondition: Returns the spawn to start the set
+    // operations with.
+
+    nodeType<elemType>* detachMax(nodeType<elemType>* &p);
+    //Function to unlink the node with the largest info from
+    //the nonempty AVL tree to which p points.
+    //Postcondition: Returns the unlinked node; every node on
+    // the path from p to it is rebalanced.
+
+    int nodeHeight(nodeType<elemType> *p) const;
+    //Postcondition: Returns the height stored in p, or 0 if
+    // p is nullptr.
+
+    void updateNode(nodeType<elemType> *p);
+    //Postcondition: p->height is one more than the larger
+    // height of its subtrees and p->size is one
+    // more than the sum of their sizes.
+
+    void rotateToLeft(nodeType<elemType>* &root);
+    //Postcondition: The subtree to which root points is
+    // rotated to the left; root points to the new
+    // root of the subtree.
+
+    void rotateToRight(nodeType<elemType>* &root);
+    //Postcondition: The subtree to which root points is
+    // rotated to the right; root points to the new
+    // root of the subtree.
+
+    void balance(nodeType<elemType>* &root);
+    //Function to restore the AVL property at root, assuming
+    //both subtrees of root are AVL trees whose heights differ
+    //by at most two.
+    //Postcondition: The subtree to which root points is an
+    // AVL tree and root->height is up to date.
+};
+
+template <class elemType, class allocType, class compareType>
+int avlTreeType<elemType, allocType, compareType>::nodeHeight(nodeType<elemType> *p) const
+{
+    if (p == nullptr)
+        return 0;
+    else
+        return p->height;
+}
+
+template <class elemType, class allocType, class compareType>
+void avlTreeType<elemType, allocType, compareType>::updateNode(nodeType<elemType> *p)
+{
+    int lHeight = nodeHeight(p->lLink);
+    int rHeight = nodeHeight(p->rLink);
+
+    p->height = 1 + (lHeight >= rHeight ? lHeight : rHeight);
+    p->size = 1 + this->nodeCount(p->lLink) + this->nodeCount(p->rLink);
+}
+
+template <class elemType, class allocType, class compareType>
+void avlTreeType<elemType, allocType, compareType>::rotateToLeft(nodeType<elemType>* &root)
+// The right child p of root becomes the new root of the subtree;
+// root becomes the left child of p and takes over the left subtree
+// of p as its right subtree.
+{
+    nodeType<elemType> *p = root->rLink;
+
+    root->rLink = p->lLink;
+    p->lLink = root;
+    updateNode(root);
+    updateNode(p);
+    root = p;
+} //end rotateToLeft
+
+template <class elemType, class allocType, class compareType>
+void avlTreeType<elemType, allocType, compareType>::rotateToRight(nodeType<elemType>* &root)
+// The left child p of root becomes the new root of the subtree;
+// root becomes the right child of p and takes over the right
+// subtree of p as its left subtree.
+{
+    nodeType<elemType> *p = root->lLink;
+
+    root->lLink = p->rLink;
+    p->rLink = root;
+    updateNode(root);
+    updateNode(p);
+    root = p;
+} //end rotateToRight
+
+template <class elemType, class allocType, class compareType>
+void avlTreeType<elemType, allocType, compareType>::balance(nodeType<elemType>* &root)
+// If the left subtree is two levels taller, a single right
+// rotation fixes the left-left case; the left-right case first
+// rotates the left child to the left. The right side is symmetric.
+{
+    int bFactor = nodeHeight(root->lLink) - nodeHeight(root->rLink);
+
+    if (bFactor > 1)
+    {
+        if (nodeHeight(root->lLink->lLink) < nodeHeight(root->lLink->rLink))
+            rotateToLeft(root->lLink);
+        rotateToRight(root);
+    }
+    else if (bFactor < -1)
+    {
+        if (nodeHeight(root->rLink->rLink) < nodeHeight(root->rLink->lLink))
+            rotateToRight(root->rLink);
+        rotateToLeft(root);
+    }
+    else
+        updateNode(root);
+} //end balance
+
+template <class elemType, class allocType, class compareType>
+template <class itemType>
+bool avlTreeType<elemType, allocType, compareType>::insertIntoAVL(nodeType<elemType>* &p, itemType&& insertItem)
+{
+    bool inserted;
+    int order;
+
+    if (p == nullptr)
+    {
+        p = this->alloc.allocate(std::forward<itemType>(insertItem));
+        return true;
+    }
+
+    TREE_STATS_VISIT();
+    order = this->compareItems(p->info, insertItem);
+    if (order == 0)
+    {
+        reportTreeEvent(insertDuplicate);
+        return false;
+    }
+    else if (order > 0)
+        inserted = insertIntoAVL(p->lLink, std::forward<itemType>(insertItem));
+    else
+        inserted = insertIntoAVL(p->rLink, std::forward<itemType>(insertItem));
+
+    if (inserted)
+        balance(p);
+    return inserted;
+} //end insertIntoAVL
+
+template <class elemType, class allocType, class compareType>
+bool avlTreeType<elemType, allocType, compareType>::linkIntoAVL(nodeType<elemType>* &p, nodeType<elemType> *newNode)
+{
+    bool inserted;
+    int order;
+
+    if (p == nullptr)
+    {
+        p = newNode;
+        return true;
+    }
+
+    TREE_STATS_VISIT();
+    order = this->compareItems(p->info, newNode->info);
+    if (order == 0)
+        return false;
+    else if (order > 0)
+        inserted = linkIntoAVL(p->lLink, newNode);
+    else
+        inserted = linkIntoAVL(p->rLink, newNode);
+
+    if (inserted)
+        balance(p);
+    return inserted;
+} //end linkIntoAVL
+
+template <class elemType, class allocType, class compareType>
+bool avlTreeType<elemType, allocType, compareType>::insert(const elemType& insertItem)
+{
+    TREE_STATS_BEGIN();
+    bool inserted = insertIntoAVL(this->root, insertItem);
+
+    TREE_STATS_END(insertOperation, inserted);
+    return inserted;
+} //end insert
+
+template <class elemType, class allocType, class compareType>
+bool avlTreeType<elemType, allocType, compareType>::insert(elemType&& insertItem)
+{
+    TREE_STATS_BEGIN();
+    bool inserted = insertIntoAVL(this->root, std::move(insertItem));
+
+    TREE_STATS_END(insertOperation, inserted);
+    return inserted;
+} //end insert
+
+template <class elemType, class allocType, class compareType>
+template <class... argTypes>
+bool avlTreeType<elemType, allocType, compareType>::emplace(argTypes&&... args)
+{
+    TREE_STATS_BEGIN();
+    nodeType<elemType> *newNode = this->alloc.allocate(std::forward<argTypes>(args)...);
+    bool inserted = linkIntoAVL(this->root, newNode);
+
+    if (!inserted)
+    {
+        this->alloc.deallocate(newNode);
+        reportTreeEvent(insertDuplicate);
+    }
+    TREE_STATS_END(insertOperation, inserted);
+    return inserted;
+} //end emplace
+
+template <class elemType, class allocType, class compareType>
+nodeType<elemType>* avlTreeType<elemType, allocType, compareType>::detachMax(nodeType<elemType>* &p)
+{
+    nodeType<elemType> *maxNode;
+
+    TREE_STATS_WALK();
+    if (p->rLink == nullptr)
+    {
+        maxNode = p;
+        p = p->lLink;
+        return maxNode;
+    }
+
+    maxNode = detachMax(p->rLink);
+    balance(p);
+    return maxNode;
+} //end detachMax
+
+template <class elemType, class allocType, class compareType>
+template <class keyType>
+bool avlTreeType<elemType, allocType, compareType>::deleteFromAVL(nodeType<elemType>* &p, const keyType& deleteItem)
+{
+    nodeType<elemType> *temp; //pointer to delete the node
+    bool deleted;
+    int order;
+
+    if (p == nullptr)
+        return false;
+
+    TREE_STATS_VISIT();
+    order = this->compareItems(p->info, deleteItem);
+    if (order > 0)
+        deleted = deleteFromAVL(p->lLink, deleteItem);
+    else if (order < 0)
+        deleted = deleteFromAVL(p->rLink, deleteItem);
+    else if (p->lLink != nullptr && p->rLink != nullptr)
+    {
+        // Two children: unlink the inorder predecessor from the
+        // left subtree, which rebalances every node on the way back
+        // up to p, and move its info into p.
+        temp = detachMax(p->lLink);
+        p->info = std::move(temp->info);
+        this->alloc.deallocate(temp);
+        deleted = true;
+    }
+    else
+    {
+        temp = p;
+        if (p->lLink == nullptr)
+            p = temp->rLink;
+        else
+            p = temp->lLink;
+        this->alloc.deallocate(temp);
+        return true;
+    }
+
+    if (deleted)
+        balance(p);
+    return deleted;
+} //end deleteFromAVL
+
+template <class elemType, class allocType, class compareType>
+bool avlTreeType<elemType, allocType, compareType>::deleteNode(const elemType& deleteItem)
+{
+    return deleteKey(deleteItem);
+}
+
+template <class elemType, class allocType, class compareType>
+template <class keyType, class compare, class>
+bool avlTreeType<elemType, allocType, compareType>::deleteNode(const keyType& key)
+{
+    return deleteKey(key);
+}
+
+template <class elemType, class allocType, class compareType>
+template <class keyType>
+bool avlTreeType<elemType, allocType, compareType>::deleteKey(const keyType& deleteItem)
+{
+    bool deleted = false;
+
+    TREE_STATS_BEGIN();
+    if (this->root == nullptr)
+        reportTreeEvent(deleteEmptyTree);
+    else if (deleteFromAVL(this->root, deleteItem))
+        deleted = true;
+    else
+        reportTreeEvent(deleteNotFound);
+    TREE_STATS_END(deleteOperation, deleted);
+    return deleted;
+} //end deleteKey
+
+template <class elemType, class allocType, class compareType>
+void avlTreeType<elemType, allocType, compareType>::restoreBalance(nodeType<elemType>* &p)
+{
+    int bFactor = nodeHeight(p->lLink) - nodeHeight(p->rLink);
+
+    if (bFactor > 2 || bFactor < -2)
+        rebuildSubtree(p);
+    else
+        balance(p);
+} //end restoreBalance
+
+template <class elemType, class allocType, class compareType>
+void avlTreeType<elemType, allocType, compareType>::rebuildSubtree(nodeType<elemType>* &p)
+{
+    vector<nodeType<elemType>*> nodes;
+
+    nodes.reserve(this->nodeCount(p));
+    this->inorderNodes(p, nodes);
+    p = this->linkBalanced(nodes, 0, nodes.size());
+} //end rebuildSubtree
+
+template <class elemType, class allocType, class compareType>
+void avlTreeType<elemType, allocType, compareType>::mergeIntoAVL(nodeType<elemType>* &p, vector<elemType>& items,
+                size_t first, size_t last)
+{
+    size_t split;
+    bool found;
+
+    if (first == last)
+        return;
+    if (p == nullptr)
+    {
+        this->alloc.reserve(last - first);
+        p = this->buildBalanced(items, first, last);
+        return;
+    }
+
+    split = this->splitBatch(items, first, last, p->info, found);
+    mergeIntoAVL(p->lLink, items, first, split);
+    mergeIntoAVL(p->rLink, items, split + found, last);
+    restoreBalance(p);
+} //end mergeIntoAVL
+
+template <class elemType, class allocType, class compareType>
+void avlTreeType<elemType, allocType, compareType>::deleteBatchFromAVL(nodeType<elemType>* &p, const vector<elemType>& items,
+                size_t first, size_t last)
+{
+    nodeType<elemType> *temp; //pointer to delete the node
+    size_t split;
+    bool found;
+
+    if (first == last || p == nullptr)
+        return;
+
+    split = this->splitBatch(items, first, last, p->info, found);
+    deleteBatchFromAVL(p->lLink, items, first, split);
+    deleteBatchFromAVL(p->rLink, items, split + found, last);
+    if (found && p->lLink != nullptr && p->rLink != nullptr)
+    {
+        temp = detachMax(p->lLink);
+        p->info = std::move(temp->info);
+        this->alloc.deallocate(temp);
+    }
+    else if (found)
+    {
+        // The remaining subtree is already an AVL tree.
+        temp = p;
+        p = (p->lLink == nullptr) ? temp->rLink : temp->lLink;
+        this->alloc.deallocate(temp);
+        return;
+    }
+    restoreBalance(p);
+} //end deleteBatchFromAVL
+
+template <class elemType, class allocType, class compareType>
+template <class inputIterator>
+int avlTreeType<elemType, allocType, compareType>::insertBatch(inputIterator first, inputIterator last)
+{
+    vector<elemType> items;
+    int oldCount = this->nodeCount(this->root);
+
+    this->sortedItems(first, last, items);
+    mergeIntoAVL(this->root, items, 0, items.size());
+    return this->nodeCount(this->root) - oldCount;
+} //end insertBatch
+
+template <class elemType, class allocType, class compareType>
+template <class inputIterator>
+int avlTreeType<elemType, allocType, compareType>::deleteBatch(inputIterator first, inputIterator last)
+{
+    vector<elemType> items;
+    int oldCount = this->nodeCount(this->root);
+
+    this->sortedItems(first, last, items);
+    deleteBatchFromAVL(this->root, items, 0, items.size());
+    return oldCount - this->nodeCount(this->root);
+} //end deleteBatch
+
+template <class elemType, class allocType, class compareType>
+nodeType<elemType>* avlTreeType<elemType, allocType, compareType>::joinAVL(nodeType<elemType> *lTree,
+                nodeType<elemType> *middle, nodeType<elemType> *rTree)
+// The shorter tree goes down the inner spine of the taller one to
+// the first subtree at most one level taller than itself, and is
+// joined there; on the way back up each node is rebalanced, which
+// takes at most one rotation per level.
+{
+    int lHeight = nodeHeight(lTree);
+    int rHeight = nodeHeight(rTree);
+
+    if (lHeight > rHeight + 1)
+    {
+        lTree->rLink = joinAVL(lTree->rLink, middle, rTree);
+        balance(lTree);
+        return lTree;
+    }
+    if (rHeight > lHeight + 1)
+    {
+        rTree->lLink = joinAVL(lTree, middle, rTree->lLink);
+        balance(rTree);
+        return rTree;
+    }
+    middle->lLink = lTree;
+    middle->rLink = rTree;
+    updateNode(middle);
+    return middle;
+} //end joinAVL
+
+template <class elemType, class allocType, class compareType>
+nodeType<elemType>* avlTreeType<elemType, allocType, compareType>::joinAVL(nodeType<elemType> *lTree,
+                nodeType<elemType> *rTree)
+{
+    nodeType<elemType> *middle;
+
+    if (lTree == nullptr)
+        return rTree;
+    if (rTree == nullptr)
+        return lTree;
+    middle = detachMax(lTree);
+    return joinAVL(lTree, middle, rTree);
+} //end joinAVL
+
+template <class elemType, class allocType, class compareType>
+void avlTreeType<elemType, allocType, compareType>::splitAVL(nodeType<elemType> *p, const elemType& splitItem,
+                nodeType<elemType>* &lTree, nodeType<elemType>* &middle, nodeType<elemType>* &rTree)
+// Each node on the search path is joined, as the middle node, with
+// its subtree on the far side of splitItem and the part of its
+// other subtree split off below it.
+{
+    nodeType<elemType> *lPart, *rPart;
+    int order;
+
+    if (p == nullptr)
+    {
+        lTree = rTree = middle = nullptr;
+        return;
+    }
+
+    order = this->compareItems(p->info, splitItem);
+    if (order == 0)
+    {
+        lTree = p->lLink;
+        rTree = p->rLink;
+        middle = p;
+        p->lLink = p->rLink = nullptr;
+        updateNode(p);
+    }
+    else if (order > 0)
+    {
+        rPart = p->rLink;
+        splitAVL(p->lLink, splitItem, lTree, middle, lPart);
+        rTree = joinAVL(lPart, p, rPart);
+    }
+    else
+    {
+        lPart = p->lLink;
+        splitAVL(p->rLink, splitItem, rPart, middle, rTree);
+        lTree = joinAVL(lPart, p, rPart);
+    }
+} //end splitAVL
+
+template <class elemType, class allocType, class compareType>
+int avlTreeType<elemType, allocType, compareType>::parallelDepth() const
+// Every level doubles the number of halves; the statistics are not
+// synchronized, so they are only kept by serial set operations.
+{
+    int depth = 0;
+
+#ifndef BINARYTREE_STATS
+    if (allocType::threadSafe)
+        for (unsigned threads = treeThreadCount(); threads > 1; threads = (threads + 1) / 2)
+            depth++;
+#endif
+    return depth;
+} //end parallelDepth
+
+template <class elemType, class allocType, class compareType>
+nodeType<elemType>* avlTreeType<elemType, allocType, compareType>::unionAVL(nodeType<elemType> *p,
+                nodeType<elemType> *q, int spawn)
+{
+    nodeType<elemType> *lTree, *middle, *rTree;
+    nodeType<elemType> *lLink, *rLink;
+
+    if (p == nullptr)
+        return q;
+    if (q == nullptr)
+        return p;
+
+    splitAVL(q, p->info, lTree, middle, rTree);
+    if (middle != nullptr)
+        this->alloc.deallocate(middle);
+    lLink = p->lLink;
+    rLink = p->rLink;
+    if (spawn > 0 && this->nodeCount(p) + this->nodeCount(lTree) + this->nodeCount(rTree)
+                     > treeParallelismSettings().cutoff)
+    {
+        auto half = [&](size_t i)
+        {
+            if (i == 0)
+                lLink = unionAVL(lLink, lTree, spawn - 1);
+            else
+                rLink = unionAVL(rLink, rTree, spawn - 1);
+        };
+        parallelFor(2, 2, half);
+    }
+    else
+    {
+        lLink = unionAVL(lLink, lTree, 0);
+        rLink = unionAVL(rLink, rTree, 0);
+    }
+    return joinAVL(lLink, p, rLink);
+} //end unionAVL
+
+template <class elemType, class allocType, class compareType>
+nodeType<elemType>* avlTreeType<elemType, allocType, compareType>::filterAVL(nodeType<elemType> *p,
+                nodeType<elemType> *q, bool keepCommon, int spawn)
+{
+    nodeType<elemType> *lTree, *middle, *rTree;
+
+    if (p == nullptr)
+        return nullptr;
+    if (q == nullptr)
+    {
+        if (!keepCommon)
+            return p;
+        this->freeNodes(p);
+        return nullptr;
+    }
+
+    splitAVL(p, q->info, lTree, middle, rTree);
+    if (middle != nullptr && !keepCommon)
+    {
+        this->alloc.deallocate(middle);
+        middle = nullptr;
+    }
+    if (spawn > 0 && this->nodeCount(lTree) + this->nodeCount(rTree) > treeParallelismSettings().cutoff)
+    {
+        auto half = [&](size_t i)
+        {
+            if (i == 0)
+                lTree = filterAVL(lTree, q->lLink, keepCommon, spawn - 1);
+            else
+                rTree = filterAVL(rTree, q->rLink, keepCommon, spawn - 1);
+        };
+        parallelFor(2, 2, half);
+    }
+    else
+    {
+        lTree = filterAVL(lTree, q->lLink, keepCommon, 0);
+        rTree = filterAVL(rTree, q->rLink, keepCommon, 0);
+    }
+    return (middle != nullptr) ? joinAVL(lTree, middle, rTree) : joinAVL(lTree, rTree);
+} //end filterAVL
+
+template <class elemType, class allocType, class compareType>
+bool avlTreeType<elemType, allocType, compareType>::split(const elemType& splitItem,
+                avlTreeType<elemType, allocType, compareType>& greaterTree)
+{
+    nodeType<elemType> *lTree, *middle, *rTree;
+
+    if (&greaterTree == this)
+        return this->search(splitItem);
+
+    splitAVL(this->root, splitItem, lTree, middle, rTree);
+    if (middle != nullptr)
+        rTree = joinAVL(nullptr, middle, rTree);
+    this->root = lTree;
+    greaterTree.destroyTree();
+    greaterTree.root = greaterTree.adoptTree(rTree, this->alloc);
+    return (middle != nullptr);
+} //end split
+
+template <class elemType, class allocType, class compareType>
+bool avlTreeType<elemType, allocType, compareType>::join(avlTreeType<elemType, allocType, compareType>& greaterTree)
+{
+    nodeType<elemType> *last = this->root;
+    nodeType<elemType> *first = greaterTree.root;
+
+    if (&greaterTree == this)
+        return (this->root == nullptr);
+    if (first == nullptr)
+        return true;
+    if (last != nullptr)
+    {
+        while (last->rLink != nullptr)
+            last = last->rLink;
+        while (first->lLink != nullptr)
+            first = first->lLink;
+        if (this->compareItems(last->info, first->info) >= 0)
+            return false;
+    }
+
+    this->root = joinAVL(this->root, this->adoptTree(greaterTree.root, greaterTree.alloc));
+    greaterTree.root = nullptr;
+    return true;
+} //end join
+
+template <class elemType, class allocType, class compareType>
+int avlTreeType<elemType, allocType, compareType>::unionWith(avlTreeType<elemType, allocType, compareType>& otherTree)
+// Of two equivalent items, the node of this tree is kept.
+{
+    int oldCount = this->nodeCount(this->root);
+    nodeType<elemType> *q;
+
+    if (&otherTree == this)
+        return 0;
+    q = this->adoptTree(otherTree.root, otherTree.alloc);
+    otherTree.root = nullptr;
+    this->root = unionAVL(this->root, q, parallelDepth());
+    return this->nodeCount(this->root) - oldCount;
+} //end unionWith
+
+template <class elemType, class allocType, class compareType>
+int avlTreeType<elemType, allocType, compareType>::intersectWith
+                (const avlTreeType<elemType, allocType, compareType>& otherTree)
+{
+    int oldCount = this->nodeCount(this->root);
+
+    if (&otherTree == this)
+        return 0;
+    this->root = filterAVL(this->root, otherTree.root, true, parallelDepth());
+    return oldCount - this->nodeCount(this->root);
+} //end intersectWith
+
+template <class elemType, class allocType, class compareType>
+int avlTreeType<elemType, allocType, compareType>::differenceWith
+                (const avlTreeType<elemType, allocType, compareType>& otherTree)
+{
+    int oldCount = this->nodeCount(this->root);
+
+    if (&otherTree == this)
+    {
+        this->destroyTree();
+        return oldCount;
+    }
+    this->root = filterAVL(this->root, otherTree.root, false, parallelDepth());
+    return oldCount - this->nodeCount(this->root);
+} //end differenceWith
+
+#endif
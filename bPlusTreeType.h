@@ -0,0 +1,913 @@
+#ifndef BPLUSTREETYPE_H
+#define BPLUSTREETYPE_H
+
+/* A B+-tree with nodes sized to a few cache lines, for large sets of
+   small keys. bSearchTreeType has one key per node and so one cache
+   miss per level; here every node holds as many keys as fit in
+   nodeBytes (60 int keys in a 256-byte leaf), so 100M keys need 6
+   levels instead of 27.
+    1. The items are in the leaves, which are linked in sorted order;
+    inorderTraversal and rangeVisit walk along the leaves.
+    2. The inner nodes hold separator keys: keys[i] is the smallest
+    item in the subtree of children[i+1].
+    3. Within a node the position of a key is found with AVX2 vector
+    compares for int and long long items in natural order when the
+    processor supports them (checked at run time), otherwise with a
+    binary search.
+    4. Nodes are split when an insert finds them full and borrow from
+    or merge with a sibling when a delete leaves them less than half
+    full, so all leaves stay at the same depth.
+   search, insert, deleteNode and the traversal follow the contract of
+   binaryTreeType. Items must be default constructible.
+*/
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "treeCompare.h"
+#include "treeDiagnostics.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define BPLUSTREE_AVX2
+#endif
+
+using namespace std;
+
+// Definition of the leaf node
+template <class elemType, size_t nodeBytes>
+struct alignas(64) bPlusLeafType
+{
+    static constexpr int capacity = int((nodeBytes - 2 * sizeof(void*)) / sizeof(elemType)) > 4
+                                    ? int((nodeBytes - 2 * sizeof(void*)) / sizeof(elemType)) : 4;
+
+    int count;                          // Number of items
+    bPlusLeafType *next;                // Next leaf in sorted order
+    elemType keys[capacity];            // The items, sorted
+};
+
+// Definition of the inner node
+template <class elemType, size_t nodeBytes>
+struct alignas(64) bPlusInnerType
+{
+    static constexpr int capacity = int((nodeBytes - 2 * sizeof(void*)) / (sizeof(elemType) + sizeof(void*))) > 4
+                                    ? int((nodeBytes - 2 * sizeof(void*)) / (sizeof(elemType) + sizeof(void*))) : 4;
+
+    int count;                          // Number of keys; there is one
+                                        // more child
+    elemType keys[capacity];            // Separator keys
+    void *children[capacity + 1];       // Inner nodes or leaves
+};
+
+template <class elemType, class compareType = less<elemType>, size_t nodeBytes = 256>
+class bPlusTreeType
+{
+    static_assert(nodeBytes >= 64, "a node takes at least one cache line");
+
+public:
+    typedef bPlusLeafType<elemType, nodeBytes> leafType;
+    typedef bPlusInnerType<elemType, nodeBytes> innerType;
+
+    bool search(const elemType& searchItem) const;
+    //Function to determine if searchItem is in the tree.
+    //Postcondition: Returns true if searchItem is found;
+    // otherwise, returns false. Searching an empty
+    // tree reports the searchEmptyTree event.
+
+    bool insert(const elemType& insertItem);
+    bool insert(elemType&& insertItem);
+    //Function to insert insertItem in the tree.
+    //Postcondition: If there is no item equal to insertItem,
+    // it is inserted in its leaf, splitting full
+    // nodes on the way back up, and true is
+    // returned; otherwise, insertDuplicate is
+    // reported and false is returned.
+
+    bool deleteNode(const elemType& deleteItem);
+    //Function to delete deleteItem from the tree.
+    //Postcondition: If deleteItem is found, it is removed and
+    // true is returned; otherwise, deleteEmptyTree
+    // or deleteNotFound is reported and false is
+    // returned.
+
+    template <class visitor>
+    void inorderTraversal(visitor&& visit) const;
+    //Function to visit the items in sorted order with a callable
+    //object taking a const elemType&.
+
+    template <class visitor>
+    void rangeVisit(const elemType& lowItem, const elemType& highItem, visitor&& visit) const;
+    //Function to visit, in sorted order, the items x with
+    //lowItem <= x <= highItem. One descent finds the first of
+    //them; the rest are read along the leaves.
+
+    template <class inputIterator>
+    void buildTree(inputIterator first, inputIterator last);
+    //Function to replace the tree by the distinct items in
+    //[first, last), which do not have to be sorted.
+    //Postcondition: The nodes are filled evenly from the leaves
+    // up, as full as the node size allows.
+
+    bool isEmpty() const;
+    int treeNodeCount() const;
+    int treeHeight() const;
+    //Postcondition: Return whether the tree is empty, the
+    // number of items and the number of levels.
+
+    size_t memoryBytes() const;
+    //Postcondition: Returns the bytes taken by the nodes.
+
+    static bool vectorSearch();
+    //Postcondition: Returns true if the nodes are searched with
+    // AVX2 for elemType and compareType on this
+    // processor.
+
+    void destroyTree();
+    //Postcondition: The tree is empty and the nodes are freed.
+
+    const bPlusTreeType<elemType, compareType, nodeBytes>& operator=
+                (const bPlusTreeType<elemType, compareType, nodeBytes>& otherTree);
+    bPlusTreeType<elemType, compareType, nodeBytes>& operator=
+                (bPlusTreeType<elemType, compareType, nodeBytes>&& otherTree);
+    bPlusTreeType(const bPlusTreeType<elemType, compareType, nodeBytes>& otherTree);
+    bPlusTreeType(bPlusTreeType<elemType, compareType, nodeBytes>&& otherTree);
+    //Copy and move. A copy is rebuilt with buildTree; a move
+    //takes the nodes and leaves otherTree empty.
+
+    template <class inputIterator>
+    bPlusTreeType(inputIterator first, inputIterator last,
+                  const compareType& compare = compareType());
+    //Constructor that builds the tree from [first, last)
+    //with buildTree.
+
+    explicit bPlusTreeType(const compareType& compare);
+    //Constructor of an empty tree ordered by compare.
+
+    bPlusTreeType();
+    //Default constructor
+
+    ~bPlusTreeType();
+    //Destructor
+
+private:
+    int lowerPosition(const elemType* keys, int n, const elemType& item) const;
+    int upperPosition(const elemType* keys, int n, const elemType& item) const;
+    //Postcondition: Return the number of keys in keys[0..n-1]
+    // less than item, and not greater than item.
+
+#ifdef BPLUSTREE_AVX2
+    __attribute__((target("avx2")))
+    static int avx2Position(const int* keys, int n, int item, bool upper);
+    __attribute__((target("avx2")))
+    static int avx2Position(const long long* keys, int n, long long item, bool upper);
+    //lowerPosition (upper false) or upperPosition (upper true)
+    //comparing 8 int or 4 long long keys at a time.
+#endif
+
+    const leafType* findLeaf(const elemType& item) const;
+    //Postcondition: Returns the leaf where item is or would be.
+
+    template <class itemType>
+    bool insertItem(itemType&& item);
+    //Function to do insert for a copied or moved item.
+
+    template <class itemType>
+    bool insertInto(void* node, int level, itemType&& item,
+                    elemType& splitKey, void*& splitNode);
+    //Function to insert item in the subtree of node, which is a
+    //leaf if level is 1.
+    //Postcondition: Returns false if item was already there. If
+    // node had to be split, splitNode is the new
+    // right half and splitKey its smallest item;
+    // otherwise, splitNode is unchanged.
+
+    void insertChild(innerType* p, int i, const elemType& key, void* child);
+    //Function to insert key at keys[i] and child at
+    //children[i+1] of p, which is not full.
+
+    bool deleteFrom(void* node, int level, const elemType& item);
+    //Function to delete item from the subtree of node.
+    //Postcondition: Returns true if item was found. Only the
+    // root of the subtree may be left less than
+    // half full.
+
+    void fixChild(innerType* p, int i, int childLevel);
+    //Function to refill children[i] of p if it is less than half
+    //full, by borrowing a key from a sibling or merging with it.
+
+    void removeChild(innerType* p, int i);
+    //Function to remove keys[i] and children[i+1] from p.
+
+    void destroy(void* node, int level);
+    //Function to free the nodes of the subtree of node.
+
+    void* root;                         // Root node, a leaf if levels is 1
+    int levels;                         // Number of levels
+    int count;                          // Number of items
+    size_t leafCount;                   // Number of leaves
+    size_t innerCount;                  // Number of inner nodes
+    compareType comp;                   // Order of the items
+};
+
+template <class elemType, class compareType, size_t nodeBytes>
+bPlusTreeType<elemType, compareType, nodeBytes>::bPlusTreeType()
+    : root(nullptr), levels(0), count(0), leafCount(0), innerCount(0)
+{
+}
+
+template <class elemType, class compareType, size_t nodeBytes>
+bPlusTreeType<elemType, compareType, nodeBytes>::bPlusTreeType(const compareType& compare)
+    : root(nullptr), levels(0), count(0), leafCount(0), innerCount(0), comp(compare)
+{
+}
+
+template <class elemType, class compareType, size_t nodeBytes>
+template <class inputIterator>
+bPlusTreeType<elemType, compareType, nodeBytes>::bPlusTreeType
+                (inputIterator first, inputIterator last, const compareType& compare)
+    : root(nullptr), levels(0), count(0), leafCount(0), innerCount(0), comp(compare)
+{
+    buildTree(first, last);
+}
+
+template <class elemType, class compareType, size_t nodeBytes>
+bPlusTreeType<elemType, compareType, nodeBytes>::bPlusTreeType
+                (const bPlusTreeType<elemType, compareType, nodeBytes>& otherTree)
+    : root(nullptr), levels(0), count(0), leafCount(0), innerCount(0), comp(otherTree.comp)
+{
+    *this = otherTree;
+}
+
+template <class elemType, class compareType, size_t nodeBytes>
+bPlusTreeType<elemType, compareType, nodeBytes>::bPlusTreeType
+                (bPlusTreeType<elemType, compareType, nodeBytes>&& otherTree)
+    : root(nullptr), levels(0), count(0), leafCount(0), innerCount(0), comp(otherTree.comp)
+{
+    *this = std::move(otherTree);
+}
+
+template <class elemType, class compareType, size_t nodeBytes>
+bPlusTreeType<elemType, compareType, nodeBytes>::~bPlusTreeType()
+{
+    destroyTree();
+}
+
+template <class elemType, class compareType, size_t nodeBytes>
+const bPlusTreeType<elemType, compareType, nodeBytes>& bPlusTreeType<elemType, compareType, nodeBytes>::operator=
+                (const bPlusTreeType<elemType, compareType, nodeBytes>& otherTree)
+{
+    if (this != &otherTree)
+    {
+        vector<elemType> items;
+
+        items.reserve(otherTree.count);
+        otherTree.inorderTraversal([&items](const elemType& item) { items.push_back(item); });
+        comp = otherTree.comp;
+        buildTree(items.begin(), items.end());
+    }
+    return *this;
+} //end copy assignment
+
+template <class elemType, class compareType, size_t nodeBytes>
+bPlusTreeType<elemType, compareType, nodeBytes>& bPlusTreeType<elemType, compareType, nodeBytes>::operator=
+                (bPlusTreeType<elemType, compareType, nodeBytes>&& otherTree)
+{
+    if (this != &otherTree)
+    {
+        destroyTree();
+        root = otherTree.root;
+        levels = otherTree.levels;
+        count = otherTree.count;
+        leafCount = otherTree.leafCount;
+        innerCount = otherTree.innerCount;
+        comp = otherTree.comp;
+        otherTree.root = nullptr;
+        otherTree.levels = 0;
+        otherTree.count = 0;
+        otherTree.leafCount = 0;
+        otherTree.innerCount = 0;
+    }
+    return *this;
+} //end move assignment
+
+template <class elemType, class compareType, size_t nodeBytes>
+bool bPlusTreeType<elemType, compareType, nodeBytes>::isEmpty() const
+{
+    return (root == nullptr);
+}
+
+template <class elemType, class compareType, size_t nodeBytes>
+int bPlusTreeType<elemType, compareType, nodeBytes>::treeNodeCount() const
+{
+    return count;
+}
+
+template <class elemType, class compareType, size_t nodeBytes>
+int bPlusTreeType<elemType, compareType, nodeBytes>::treeHeight() const
+{
+    return levels;
+}
+
+template <class elemType, class compareType, size_t nodeBytes>
+size_t bPlusTreeType<elemType, compareType, nodeBytes>::memoryBytes() const
+{
+    return leafCount * sizeof(leafType) + innerCount * sizeof(innerType);
+}
+
+template <class elemType, class compareType, size_t nodeBytes>
+void bPlusTreeType<elemType, compareType, nodeBytes>::destroyTree()
+{
+    if (root != nullptr)
+        destroy(root, levels);
+    root = nullptr;
+    levels = 0;
+    count = 0;
+    leafCount = 0;
+    innerCount = 0;
+}
+
+template <class elemType, class compareType, size_t nodeBytes>
+void bPlusTreeType<elemType, compareType, nodeBytes>::destroy(void* node, int level)
+{
+    if (level == 1)
+        delete static_cast<leafType*>(node);
+    else
+    {
+        innerType *p = static_cast<innerType*>(node);
+
+        for (int i = 0; i <= p->count; i++)
+            destroy(p->children[i], level - 1);
+        delete p;
+    }
+} //end destroy
+
+template <class elemType, class compareType, size_t nodeBytes>
+bool bPlusTreeType<elemType, compareType, nodeBytes>::vectorSearch()
+{
+#ifdef BPLUSTREE_AVX2
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+
+    return avx2 && isNaturalOrder<compareType>::value
+           && (is_same<elemType, int>::value || is_same<elemType, long long>::value);
+#else
+    return false;
+#endif
+}
+
+#ifdef BPLUSTREE_AVX2
+template <class elemType, class compareType, size_t nodeBytes>
+__attribute__((target("avx2")))
+int bPlusTreeType<elemType, compareType, nodeBytes>::avx2Position
+                (const int* keys, int n, int item, bool upper)
+// Counting the keys on one side of item needs no branches; a node
+// is a few vectors long, so comparing all of them costs less than
+// the mispredicted branches of a binary search.
+{
+    const __m256i key = _mm256_set1_epi32(item);
+    int i = 0, found = 0;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i k = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i));
+        __m256i side = upper ? _mm256_cmpgt_epi32(k, key) : _mm256_cmpgt_epi32(key, k);
+        found += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(side)));
+    }
+    for (; i < n; i++)
+        found += upper ? (keys[i] > item) : (keys[i] < item);
+    return upper ? n - found : found;
+} //end avx2Position
+
+template <class elemType, class compareType, size_t nodeBytes>
+__attribute__((target("avx2")))
+int bPlusTreeType<elemType, compareType, nodeBytes>::avx2Position
+                (const long long* keys, int n, long long item, bool upper)
+{
+    const __m256i key = _mm256_set1_epi64x(item);
+    int i = 0, found = 0;
+
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256i k = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i));
+        __m256i side = upper ? _mm256_cmpgt_epi64(k, key) : _mm256_cmpgt_epi64(key, k);
+        found += __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(side)));
+    }
+    for (; i < n; i++)
+        found += upper ? (keys[i] > item) : (keys[i] < item);
+    return upper ? n - found : found;
+} //end avx2Position
+#endif
+
+template <class elemType, class compareType, size_t nodeBytes>
+int bPlusTreeType<elemType, compareType, nodeBytes>::lowerPosition
+                (const elemType* keys, int n, const elemType& item) const
+{
+#ifdef BPLUSTREE_AVX2
+    if constexpr (isNaturalOrder<compareType>::value
+                  && (is_same<elemType, int>::value || is_same<elemType, long long>::value))
+    {
+        if (vectorSearch())
+            return avx2Position(keys, n, item, false);
+    }
+#endif
+    int low = 0, high = n;
+
+    while (low < high)
+    {
+        int mid = (low + high) / 2;
+
+        if (comp(keys[mid], item))
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+} //end lowerPosition
+
+template <class elemType, class compareType, size_t nodeBytes>
+int bPlusTreeType<elemType, compareType, nodeBytes>::upperPosition
+                (const elemType* keys, int n, const elemType& item) const
+{
+#ifdef BPLUSTREE_AVX2
+    if constexpr (isNaturalOrder<compareType>::value
+                  && (is_same<elemType, int>::value || is_same<elemType, long long>::value))
+    {
+        if (vectorSearch())
+            return avx2Position(keys, n, item, true);
+    }
+#endif
+    int low = 0, high = n;
+
+    while (low < high)
+    {
+        int mid = (low + high) / 2;
+
+        if (comp(item, keys[mid]))
+            high = mid;
+        else
+            low = mid + 1;
+    }
+    return low;
+} //end upperPosition
+
+template <class elemType, class compareType, size_t nodeBytes>
+const typename bPlusTreeType<elemType, compareType, nodeBytes>::leafType*
+bPlusTreeType<elemType, compareType, nodeBytes>::findLeaf(const elemType& item) const
+{
+    void *node = root;
+
+    for (int level = levels; level > 1; level--)
+    {
+        const innerType *p = static_cast<const innerType*>(node);
+
+        node = p->children[upperPosition(p->keys, p->count, item)];
+    }
+    return static_cast<const leafType*>(node);
+} //end findLeaf
+
+template <class elemType, class compareType, size_t nodeBytes>
+bool bPlusTreeType<elemType, compareType, nodeBytes>::search(const elemType& searchItem) const
+{
+    if (root == nullptr)
+    {
+        reportTreeEvent(searchEmptyTree);
+        return false;
+    }
+
+    const leafType *leaf = findLeaf(searchItem);
+    int pos = lowerPosition(leaf->keys, leaf->count, searchItem);
+
+    return (pos < leaf->count && !comp(searchItem, leaf->keys[pos]));
+} //end search
+
+template <class elemType, class compareType, size_t nodeBytes>
+template <class visitor>
+void bPlusTreeType<elemType, compareType, nodeBytes>::inorderTraversal(visitor&& visit) const
+{
+    if (root == nullptr)
+        return;
+
+    void *node = root;
+
+    for (int level = levels; level > 1; level--)
+        node = static_cast<innerType*>(node)->children[0];
+    for (const leafType *leaf = static_cast<const leafType*>(node); leaf != nullptr; leaf = leaf->next)
+        for (int i = 0; i < leaf->count; i++)
+            visit(leaf->keys[i]);
+} //end inorderTraversal
+
+template <class elemType, class compareType, size_t nodeBytes>
+template <class visitor>
+void bPlusTreeType<elemType, compareType, nodeBytes>::rangeVisit
+                (const elemType& lowItem, const elemType& highItem, visitor&& visit) const
+{
+    if (root == nullptr)
+        return;
+
+    const leafType *leaf = findLeaf(lowItem);
+
+    for (int i = lowerPosition(leaf->keys, leaf->count, lowItem); leaf != nullptr; leaf = leaf->next, i = 0)
+        for (; i < leaf->count; i++)
+        {
+            if (comp(highItem, leaf->keys[i]))
+                return;
+            visit(leaf->keys[i]);
+        }
+} //end rangeVisit
+
+template <class elemType, class compareType, size_t nodeBytes>
+bool bPlusTreeType<elemType, compareType, nodeBytes>::insert(const elemType& insertItem)
+{
+    return this->insertItem(insertItem);
+}
+
+template <class elemType, class compareType, size_t nodeBytes>
+bool bPlusTreeType<elemType, compareType, nodeBytes>::insert(elemType&& insertItem)
+{
+    return this->insertItem(std::move(insertItem));
+}
+
+template <class elemType, class compareType, size_t nodeBytes>
+template <class itemType>
+bool bPlusTreeType<elemType, compareType, nodeBytes>::insertItem(itemType&& item)
+// A split of the root adds a level above it.
+{
+    elemType splitKey;
+    void *splitNode = nullptr;
+
+    if (root == nullptr)
+    {
+        root = new leafType();
+        levels = 1;
+        leafCount = 1;
+    }
+    if (!insertInto(root, levels, std::forward<itemType>(item), splitKey, splitNode))
+    {
+        reportTreeEvent(insertDuplicate);
+        return false;
+    }
+    if (splitNode != nullptr)
+    {
+        innerType *newRoot = new innerType();
+
+        newRoot->count = 1;
+        newRoot->keys[0] = std::move(splitKey);
+        newRoot->children[0] = root;
+        newRoot->children[1] = splitNode;
+        root = newRoot;
+        levels++;
+        innerCount++;
+    }
+    count++;
+    return true;
+} //end insertItem
+
+template <class elemType, class compareType, size_t nodeBytes>
+void bPlusTreeType<elemType, compareType, nodeBytes>::insertChild
+                (innerType* p, int i, const elemType& key, void* child)
+{
+    move_backward(p->keys + i, p->keys + p->count, p->keys + p->count + 1);
+    move_backward(p->children + i + 1, p->children + p->count + 1, p->children + p->count + 2);
+    p->keys[i] = key;
+    p->children[i + 1] = child;
+    p->count++;
+} //end insertChild
+
+template <class elemType, class compareType, size_t nodeBytes>
+template <class itemType>
+bool bPlusTreeType<elemType, compareType, nodeBytes>::insertInto
+                (void* node, int level, itemType&& item, elemType& splitKey, void*& splitNode)
+// A full node is split in two halves before the new key goes into
+// one of them. In a leaf the right half starts with its smallest
+// item, which becomes the separator; in an inner node the middle key
+// moves up to the parent instead.
+{
+    if (level == 1)
+    {
+        leafType *leaf = static_cast<leafType*>(node);
+        int pos = lowerPosition(leaf->keys, leaf->count, item);
+
+        if (pos < leaf->count && !comp(item, leaf->keys[pos]))
+            return false;
+        if (leaf->count == leafType::capacity)
+        {
+            leafType *right = new leafType();
+            int half = (leafType::capacity + 1) / 2;
+
+            move(leaf->keys + half, leaf->keys + leafType::capacity, right->keys);
+            right->count = leafType::capacity - half;
+            leaf->count = half;
+            right->next = leaf->next;
+            leaf->next = right;
+            leafCount++;
+            splitNode = right;
+            if (pos > half)
+            {
+                leaf = right;
+                pos -= half;
+            }
+        }
+        move_backward(leaf->keys + pos, leaf->keys + leaf->count, leaf->keys + leaf->count + 1);
+        leaf->keys[pos] = std::forward<itemType>(item);
+        leaf->count++;
+        if (splitNode != nullptr)
+            splitKey = static_cast<leafType*>(splitNode)->keys[0];
+        return true;
+    }
+
+    innerType *p = static_cast<innerType*>(node);
+    int i = upperPosition(p->keys, p->count, item);
+    elemType childKey;
+    void *childSplit = nullptr;
+
+    if (!insertInto(p->children[i], level - 1, std::forward<itemType>(item), childKey, childSplit))
+        return false;
+    if (childSplit == nullptr)
+        return true;
+    if (p->count < innerType::capacity)
+    {
+        insertChild(p, i, childKey, childSplit);
+        return true;
+    }
+
+    // The left half keeps half keys and the right half the other
+    // capacity - half; the key between them moves up.
+    innerType *right = new innerType();
+    int half = (innerType::capacity + 1) / 2;
+
+    innerCount++;
+    splitNode = right;
+    if (i < half)
+    {
+        splitKey = std::move(p->keys[half - 1]);
+        move(p->keys + half, p->keys + innerType::capacity, right->keys);
+        copy(p->children + half, p->children + innerType::capacity + 1, right->children);
+        right->count = innerType::capacity - half;
+        p->count = half - 1;
+        insertChild(p, i, childKey, childSplit);
+    }
+    else if (i == half)
+    {
+        splitKey = std::move(childKey);
+        move(p->keys + half, p->keys + innerType::capacity, right->keys);
+        right->children[0] = childSplit;
+        copy(p->children + half + 1, p->children + innerType::capacity + 1, right->children + 1);
+        right->count = innerType::capacity - half;
+        p->count = half;
+    }
+    else
+    {
+        splitKey = std::move(p->keys[half]);
+        move(p->keys + half + 1, p->keys + innerType::capacity, right->keys);
+        copy(p->children + half + 1, p->children + innerType::capacity + 1, right->children);
+        right->count = innerType::capacity - half - 1;
+        p->count = half;
+        insertChild(right, i - half - 1, childKey, childSplit);
+    }
+    return true;
+} //end insertInto
+
+template <class elemType, class compareType, size_t nodeBytes>
+bool bPlusTreeType<elemType, compareType, nodeBytes>::deleteNode(const elemType& deleteItem)
+// A root left with no keys is replaced by its only child.
+{
+    if (root == nullptr)
+    {
+        reportTreeEvent(deleteEmptyTree);
+        return false;
+    }
+    if (!deleteFrom(root, levels, deleteItem))
+    {
+        reportTreeEvent(deleteNotFound);
+        return false;
+    }
+    count--;
+    if (levels == 1 && static_cast<leafType*>(root)->count == 0)
+    {
+        delete static_cast<leafType*>(root);
+        root = nullptr;
+        levels = 0;
+        leafCount = 0;
+    }
+    else if (levels > 1 && static_cast<innerType*>(root)->count == 0)
+    {
+        innerType *oldRoot = static_cast<innerType*>(root);
+
+        root = oldRoot->children[0];
+        delete oldRoot;
+        levels--;
+        innerCount--;
+    }
+    return true;
+} //end deleteNode
+
+template <class elemType, class compareType, size_t nodeBytes>
+bool bPlusTreeType<elemType, compareType, nodeBytes>::deleteFrom
+                (void* node, int level, const elemType& item)
+{
+    if (level == 1)
+    {
+        leafType *leaf = static_cast<leafType*>(node);
+        int pos = lowerPosition(leaf->keys, leaf->count, item);
+
+        if (pos == leaf->count || comp(item, leaf->keys[pos]))
+            return false;
+        move(leaf->keys + pos + 1, leaf->keys + leaf->count, leaf->keys + pos);
+        leaf->count--;
+        leaf->keys[leaf->count] = elemType();
+        return true;
+    }
+
+    innerType *p = static_cast<innerType*>(node);
+    int i = upperPosition(p->keys, p->count, item);
+
+    if (!deleteFrom(p->children[i], level - 1, item))
+        return false;
+    fixChild(p, i, level - 1);
+    return true;
+} //end deleteFrom
+
+template <class elemType, class compareType, size_t nodeBytes>
+void bPlusTreeType<elemType, compareType, nodeBytes>::removeChild(innerType* p, int i)
+{
+    move(p->keys + i + 1, p->keys + p->count, p->keys + i);
+    copy(p->children + i + 2, p->children + p->count + 1, p->children + i + 1);
+    p->count--;
+    p->keys[p->count] = elemType();
+} //end removeChild
+
+template <class elemType, class compareType, size_t nodeBytes>
+void bPlusTreeType<elemType, compareType, nodeBytes>::fixChild(innerType* p, int i, int childLevel)
+// A sibling with more than half its capacity gives one key; otherwise
+// the child is merged with it, which fits because neither is more
+// than half full. A leaf borrows an item and the separator becomes
+// the new smallest item of the right one; an inner node rotates a
+// key through the parent.
+{
+    if (childLevel == 1)
+    {
+        const int minimum = leafType::capacity / 2;
+        leafType *c = static_cast<leafType*>(p->children[i]);
+        leafType *l = (i > 0) ? static_cast<leafType*>(p->children[i - 1]) : nullptr;
+        leafType *r = (i < p->count) ? static_cast<leafType*>(p->children[i + 1]) : nullptr;
+
+        if (c->count >= minimum)
+            return;
+        if (l != nullptr && l->count > minimum)
+        {
+            move_backward(c->keys, c->keys + c->count, c->keys + c->count + 1);
+            c->keys[0] = std::move(l->keys[l->count - 1]);
+            c->count++;
+            l->count--;
+            p->keys[i - 1] = c->keys[0];
+        }
+        else if (r != nullptr && r->count > minimum)
+        {
+            c->keys[c->count++] = std::move(r->keys[0]);
+            move(r->keys + 1, r->keys + r->count, r->keys);
+            r->count--;
+            p->keys[i] = r->keys[0];
+        }
+        else
+        {
+            if (l == nullptr)
+            {
+                l = c;
+                c = r;
+                i++;
+            }
+            move(c->keys, c->keys + c->count, l->keys + l->count);
+            l->count += c->count;
+            l->next = c->next;
+            delete c;
+            leafCount--;
+            removeChild(p, i - 1);
+        }
+        return;
+    }
+
+    const int minimum = innerType::capacity / 2;
+    innerType *c = static_cast<innerType*>(p->children[i]);
+    innerType *l = (i > 0) ? static_cast<innerType*>(p->children[i - 1]) : nullptr;
+    innerType *r = (i < p->count) ? static_cast<innerType*>(p->children[i + 1]) : nullptr;
+
+    if (c->count >= minimum)
+        return;
+    if (l != nullptr && l->count > minimum)
+    {
+        move_backward(c->keys, c->keys + c->count, c->keys + c->count + 1);
+        copy_backward(c->children, c->children + c->count + 1, c->children + c->count + 2);
+        c->keys[0] = std::move(p->keys[i - 1]);
+        c->children[0] = l->children[l->count];
+        c->count++;
+        p->keys[i - 1] = std::move(l->keys[l->count - 1]);
+        l->count--;
+    }
+    else if (r != nullptr && r->count > minimum)
+    {
+        c->keys[c->count] = std::move(p->keys[i]);
+        c->children[c->count + 1] = r->children[0];
+        c->count++;
+        p->keys[i] = std::move(r->keys[0]);
+        move(r->keys + 1, r->keys + r->count, r->keys);
+        copy(r->children + 1, r->children + r->count + 1, r->children);
+        r->count--;
+    }
+    else
+    {
+        if (l == nullptr)
+        {
+            l = c;
+            c = r;
+            i++;
+        }
+        l->keys[l->count] = std::move(p->keys[i - 1]);
+        move(c->keys, c->keys + c->count, l->keys + l->count + 1);
+        copy(c->children, c->children + c->count + 1, l->children + l->count + 1);
+        l->count += c->count + 1;
+        delete c;
+        innerCount--;
+        removeChild(p, i - 1);
+    }
+} //end fixChild
+
+template <class elemType, class compareType, size_t nodeBytes>
+template <class inputIterator>
+void bPlusTreeType<elemType, compareType, nodeBytes>::buildTree(inputIterator first, inputIterator last)
+// The items are spread evenly over the fewest leaves that hold them,
+// and each level of inner nodes is built the same way over the level
+// below, keeping the smallest item of every node as its separator.
+{
+    vector<elemType> items(first, last);
+
+    if (!is_sorted(items.begin(), items.end(), comp))
+        sort(items.begin(), items.end(), comp);
+    items.erase(unique(items.begin(), items.end(),
+                       [this](const elemType& a, const elemType& b) { return !comp(a, b); }),
+                items.end());
+
+    destroyTree();
+    if (items.empty())
+        return;
+
+    size_t n = items.size();
+    size_t groups = (n + leafType::capacity - 1) / leafType::capacity;
+    vector<void*> nodes(groups);
+    vector<elemType> smallest(groups);
+    leafType *previous = nullptr;
+    size_t next = 0;
+
+    for (size_t g = 0; g < groups; g++)
+    {
+        leafType *leaf = new leafType();
+        size_t size = n / groups + (g < n % groups);
+
+        move(items.begin() + next, items.begin() + next + size, leaf->keys);
+        leaf->count = static_cast<int>(size);
+        smallest[g] = leaf->keys[0];
+        if (previous != nullptr)
+            previous->next = leaf;
+        previous = leaf;
+        nodes[g] = leaf;
+        next += size;
+    }
+    leafCount = groups;
+    levels = 1;
+
+    while (nodes.size() > 1)
+    {
+        n = nodes.size();
+        groups = (n + innerType::capacity) / (innerType::capacity + 1);
+        vector<void*> parents(groups);
+        vector<elemType> parentSmallest(groups);
+
+        next = 0;
+        for (size_t g = 0; g < groups; g++)
+        {
+            innerType *p = new innerType();
+            size_t size = n / groups + (g < n % groups);
+
+            for (size_t c = 0; c < size; c++)
+            {
+                p->children[c] = nodes[next + c];
+                if (c > 0)
+                    p->keys[c - 1] = std::move(smallest[next + c]);
+            }
+            p->count = static_cast<int>(size) - 1;
+            parentSmallest[g] = std::move(smallest[next]);
+            parents[g] = p;
+            next += size;
+        }
+        innerCount += groups;
+        levels++;
+        nodes.swap(parents);
+        smallest.swap(parentSmallest);
+    }
+    root = nodes[0];
+    count = static_cast<int>(items.size());
+} //end buildTree
+
+#endif
@@ -0,0 +1,287 @@
+#ifndef BSEARCHMAPTYPE_H
+#define BSEARCHMAPTYPE_H
+
+/* A map from keys to values kept in a binary search tree.
+   Every node holds one mapEntry, a key with its mapped value; the tree
+   is ordered by the keys only, so a lookup never compares or copies a
+   value. find returns a pointer to the value in the node, so a value
+   is updated in place instead of being deleted and inserted again.
+   All of bSearchTreeType is available as well; search, deleteNode,
+   rank, countRange, lowerBound and upperBound take a key directly.
+   As for the items of the trees, keyType and mappedType must be
+   copyable.
+*/
+
+#include <iostream>
+#include <type_traits>
+#include <utility>
+#include "bSearchTreeType.h"
+
+using namespace std;
+
+// Definition of the item stored in the nodes of the map
+template <class keyType, class mappedType>
+struct mapEntry
+{
+    keyType key;
+    mappedType value;
+
+    template <class keyArg, class... valueArgs,
+              class = typename enable_if<!is_same<typename decay<keyArg>::type,
+                                                  mapEntry>::value>::type>
+    explicit mapEntry(keyArg&& k, valueArgs&&... args)
+        : key(std::forward<keyArg>(k)), value(std::forward<valueArgs>(args)...) {}
+    //Constructor that builds the key from k and the value from
+    //args.
+
+    mapEntry() : key(), value() {}
+};
+
+// Order of the entries by their keys. It is transparent, so the tree
+// can be searched with a key instead of a whole entry.
+template <class keyType, class mappedType, class compareType>
+struct mapKeyCompare
+{
+    typedef void is_transparent;
+
+    compareType keyComp;
+
+    template <class leftType, class rightType>
+    bool operator()(const leftType& a, const rightType& b) const
+    {
+        return keyComp(keyOf(a), keyOf(b));
+    }
+
+    template <class leftType, class rightType>
+    int compare(const leftType& a, const rightType& b) const
+    {
+        return treeCompare(keyComp, keyOf(a), keyOf(b));
+    }
+
+    static const keyType& keyOf(const mapEntry<keyType, mappedType>& entry)
+    {
+        return entry.key;
+    }
+
+    template <class otherType>
+    static const otherType& keyOf(const otherType& key)
+    {
+        return key;
+    }
+
+    mapKeyCompare() {}
+    explicit mapKeyCompare(const compareType& compare) : keyComp(compare) {}
+};
+
+template <class keyType, class mappedType,
+          class allocType = nodeAllocator<mapEntry<keyType, mappedType> >,
+          class compareType = less<keyType> >
+class bSearchMapType: public bSearchTreeType<mapEntry<keyType, mappedType>, allocType,
+                                             mapKeyCompare<keyType, mappedType, compareType> >
+{
+public:
+    typedef mapEntry<keyType, mappedType> entryType;
+
+    mappedType* find(const keyType& key);
+    const mappedType* find(const keyType& key) const;
+    //Function to find the value mapped to key.
+    //Postcondition: Returns a pointer to the value in the node
+    // with key, or nullptr if key is not in the map.
+    // The pointer stays valid until that entry is
+    // deleted.
+
+    mappedType& operator[](const keyType& key);
+    mappedType& operator[](keyType&& key);
+    //Function to access the value mapped to key.
+    //Postcondition: Returns a reference to the value mapped to
+    // key; if key was not in the map, an entry with
+    // key and a value-initialized value is inserted
+    // first.
+
+    template <class valueArg>
+    bool insertOrAssign(const keyType& key, valueArg&& value);
+    template <class valueArg>
+    bool insertOrAssign(keyType&& key, valueArg&& value);
+    //Function to map key to value.
+    //Postcondition: If key is in the map, value is assigned to
+    // its mapped value and false is returned;
+    // otherwise, an entry with key and value is
+    // inserted and true is returned.
+
+    template <class... argTypes>
+    bool tryEmplace(const keyType& key, argTypes&&... args);
+    template <class... argTypes>
+    bool tryEmplace(keyType&& key, argTypes&&... args);
+    //Function to insert key with a value constructed from args
+    //directly in a new node.
+    //Postcondition: If key is not in the map, the entry is
+    // inserted and true is returned; otherwise,
+    // the map and args are unchanged and false is
+    // returned. No insertDuplicate is reported.
+
+    template <class inputIterator>
+    bSearchMapType(inputIterator first, inputIterator last,
+                   const compareType& compare = compareType());
+    //Constructor that builds the map from the entries in
+    //[first, last) with buildTree; of entries with the same
+    //key, only one is kept.
+
+    explicit bSearchMapType(const compareType& compare);
+    //Constructor of an empty map ordered by compare.
+
+    bSearchMapType();
+    //Default constructor
+
+private:
+    typedef bSearchTreeType<entryType, allocType, mapKeyCompare<keyType, mappedType, compareType> > baseType;
+
+    template <class keyArg, class... argTypes>
+    nodeType<entryType>* findOrInsert(bool& inserted, keyArg&& key, argTypes&&... args);
+    //Function to find the node with key, inserting an entry with
+    //key and a value constructed from args if there is none.
+    //Postcondition: Returns the node with key; inserted is true
+    // if the node is new. args are only used for
+    // a new node.
+};
+
+template <class keyType, class mappedType, class allocType, class compareType>
+bSearchMapType<keyType, mappedType, allocType, compareType>::bSearchMapType()
+{
+}
+
+template <class keyType, class mappedType, class allocType, class compareType>
+bSearchMapType<keyType, mappedType, allocType, compareType>::bSearchMapType(const compareType& compare)
+    : bSearchTreeType<entryType, allocType, mapKeyCompare<keyType, mappedType, compareType> >
+          (mapKeyCompare<keyType, mappedType, compareType>(compare))
+{
+}
+
+template <class keyType, class mappedType, class allocType, class compareType>
+template <class inputIterator>
+bSearchMapType<keyType, mappedType, allocType, compareType>::bSearchMapType
+                (inputIterator first, inputIterator last, const compareType& compare)
+    : bSearchTreeType<entryType, allocType, mapKeyCompare<keyType, mappedType, compareType> >
+          (first, last, mapKeyCompare<keyType, mappedType, compareType>(compare))
+{
+}
+
+template <class keyType, class mappedType, class allocType, class compareType>
+template <class keyArg, class... argTypes>
+nodeType<mapEntry<keyType, mappedType> >*
+bSearchMapType<keyType, mappedType, allocType, compareType>::findOrInsert
+                (bool& inserted, keyArg&& key, argTypes&&... args)
+// The same descent as insert, but it stops at the node with key
+// instead of treating it as a duplicate. Finding the key changes no
+// size, so the path is kept and only a new node adds one to the
+// sizes on it.
+{
+    nodeType<entryType> *path[baseType::maxPath];
+    int depth;
+    TREE_STATS_BEGIN();
+    nodeType<entryType>* *link = this->findPath(key, path, depth);
+
+    inserted = (*link == nullptr);
+    if (inserted)
+    {
+        *link = this->alloc.allocate(std::forward<keyArg>(key), std::forward<argTypes>(args)...);
+        this->updatePath(path, depth, (*link)->info.key, 1);
+    }
+    TREE_STATS_END(insertOperation, inserted);
+    return *link;
+} //end findOrInsert
+
+template <class keyType, class mappedType, class allocType, class compareType>
+const mappedType* bSearchMapType<keyType, mappedType, allocType, compareType>::find
+                (const keyType& key) const
+{
+    nodeType<entryType> *current = this->root;
+    int order;
+    TREE_STATS_BEGIN();
+    if (this->root == nullptr)
+        reportTreeEvent(searchEmptyTree);
+    while (current != nullptr)
+    {
+        TREE_STATS_VISIT();
+        order = this->compareItems(current->info, key);
+        if (order == 0)
+            break;
+        else if (order > 0)
+            current = current->lLink;
+        else
+            current = current->rLink;
+    }
+    TREE_STATS_END(searchOperation, current != nullptr);
+    return (current == nullptr) ? nullptr : &current->info.value;
+} //end find
+
+template <class keyType, class mappedType, class allocType, class compareType>
+mappedType* bSearchMapType<keyType, mappedType, allocType, compareType>::find(const keyType& key)
+{
+    return const_cast<mappedType*>(static_cast<const bSearchMapType*>(this)->find(key));
+}
+
+template <class keyType, class mappedType, class allocType, class compareType>
+mappedType& bSearchMapType<keyType, mappedType, allocType, compareType>::operator[](const keyType& key)
+{
+    bool inserted;
+
+    return findOrInsert(inserted, key)->info.value;
+}
+
+template <class keyType, class mappedType, class allocType, class compareType>
+mappedType& bSearchMapType<keyType, mappedType, allocType, compareType>::operator[](keyType&& key)
+{
+    bool inserted;
+
+    return findOrInsert(inserted, std::move(key))->info.value;
+}
+
+template <class keyType, class mappedType, class allocType, class compareType>
+template <class valueArg>
+bool bSearchMapType<keyType, mappedType, allocType, compareType>::insertOrAssign
+                (const keyType& key, valueArg&& value)
+{
+    bool inserted;
+    nodeType<entryType> *p = findOrInsert(inserted, key, std::forward<valueArg>(value));
+
+    if (!inserted)
+        p->info.value = std::forward<valueArg>(value);
+    return inserted;
+} //end insertOrAssign
+
+template <class keyType, class mappedType, class allocType, class compareType>
+template <class valueArg>
+bool bSearchMapType<keyType, mappedType, allocType, compareType>::insertOrAssign
+                (keyType&& key, valueArg&& value)
+{
+    bool inserted;
+    nodeType<entryType> *p = findOrInsert(inserted, std::move(key), std::forward<valueArg>(value));
+
+    if (!inserted)
+        p->info.value = std::forward<valueArg>(value);
+    return inserted;
+} //end insertOrAssign
+
+template <class keyType, class mappedType, class allocType, class compareType>
+template <class... argTypes>
+bool bSearchMapType<keyType, mappedType, allocType, compareType>::tryEmplace
+                (const keyType& key, argTypes&&... args)
+{
+    bool inserted;
+
+    findOrInsert(inserted, key, std::forward<argTypes>(args)...);
+    return inserted;
+} //end tryEmplace
+
+template <class keyType, class mappedType, class allocType, class compareType>
+template <class... argTypes>
+bool bSearchMapType<keyType, mappedType, allocType, compareType>::tryEmplace
+                (keyType&& key, argTypes&&... args)
+{
+    bool inserted;
+
+    findOrInsert(inserted, std::move(key), std::forward<argTypes>(args)...);
+    return inserted;
+} //end tryEmplace
+
+#endif
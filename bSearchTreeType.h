@@ -7,40 +7,401 @@
     3. The key in the root node is larger than every key in
     the left subtree and smaller than every key in the right subtree/
     4. Lt and Rt are binary subtree.
+   The order of the keys is given by compareType (less<elemType> by
+   default, see treeCompare.h); each node on a search path costs one
+   three-way comparison.
 */
 
 #include <iostream>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <type_traits>
 #include "binaryTreeType.h"
+#include "treeCompare.h"
+#include "treeFileFormat.h"
 
 using namespace std;
 
-template <class elemType>
-class bSearchTreeType: public binaryTreeType<elemType>
+template <class elemType, class allocType = nodeAllocator<elemType>,
+          class compareType = less<elemType> >
+class bSearchTreeType: public binaryTreeType<elemType, allocType>
 {
 public:
+    typedef typename binaryTreeType<elemType, allocType>::const_iterator const_iterator;
+
     bool search(const elemType& searchItem) const;
     //Function to determine if searchItem is in the binary
     //search tree.
     //Postcondition: Returns true if searchItem is found in
     // the binary search tree; otherwise,
-    // returns false.
-    void insert(const elemType& insertItem);
+    // returns false. Searching an empty tree
+    // reports the searchEmptyTree event.
+    template <class keyType, class compare = compareType,
+              class = typename compare::is_transparent>
+    bool search(const keyType& key) const;
+    //Function to search for an item equivalent to key,
+    //which does not have to be an elemType, e.g. a string_view
+    //in a tree of string. Only available when compareType is
+    //transparent (has a member type is_transparent, as less<>).
+    //Postcondition: Same as above.
+    void searchBatch(const elemType* keys, size_t n, bool* out) const;
+    //Function to search for the n items keys[0..n-1].
+    //The searches are run in groups that advance one level
+    //at a time, so the memory loads of the nodes of different
+    //searches overlap instead of waiting for each other.
+    //Postcondition: out[i] is true if keys[i] is found in the
+    // binary search tree; otherwise, out[i] is
+    // false.
+    bool insert(const elemType& insertItem);
+    bool insert(elemType&& insertItem);
     //Function to insert insertItem in the binary search tree.
     //Postcondition: If there is no node in the binary search
     // tree that has the same info as
     // insertItem, a node with the info
     // insertItem is created and inserted in the
-    // binary search tree.
-    void deleteNode(const elemType& deleteItem);
+    // binary search tree and true is returned;
+    // otherwise, insertDuplicate is reported and
+    // false is returned. The second version
+    // moves insertItem into the node.
+    template <class... argTypes>
+    bool emplace(argTypes&&... args);
+    //Function to insert an item constructed from args.
+    //The item is constructed directly in a new node; if it
+    //turns out to be a duplicate, the node is destroyed again.
+    //Postcondition: Same as insert.
+    bool deleteNode(const elemType& deleteItem);
     //Function to delete deleteItem from the binary search tree
     //Postcondition: If a node with the same info as
     // deleteItem is found, it is deleted from
-    // the binary search tree.
+    // the binary search tree and true is
+    // returned.
     // If the binary tree is empty or deleteItem
-    // is not in the binary tree, an appropriate
-    // message is printed.
-    
+    // is not in the binary tree, deleteEmptyTree
+    // or deleteNotFound is reported and false
+    // is returned.
+    template <class keyType, class compare = compareType,
+              class = typename compare::is_transparent>
+    bool deleteNode(const keyType& key);
+    //Function to delete the item equivalent to key;
+    //only available when compareType is transparent.
+    //Postcondition: Same as above.
+
+    int rank(const elemType& item) const;
+    //Function to determine the number of items in the binary
+    //search tree that are less than item. Takes O(height) time
+    //using the subtree sizes stored in the nodes.
+    //Postcondition: Returns the number of items less than item;
+    // if item is in the tree, this is its position
+    // (starting at 0) in inorder sequence.
+
+    const_iterator select(int k) const;
+    //Function to find the item at position k (starting at 0)
+    //in inorder sequence. Takes O(height) time.
+    //Postcondition: Returns an iterator to the k-th smallest
+    // item, or end() if k < 0 or k >= treeNodeCount().
+
+    int countRange(const elemType& lowItem, const elemType& highItem) const;
+    //Function to count the items x with lowItem <= x <= highItem.
+    //Takes O(height) time.
+    //Postcondition: Returns the number of items in the range;
+    // 0 if highItem is less than lowItem.
+
+    const_iterator lowerBound(const elemType& item) const;
+    //Postcondition: Returns an iterator to the smallest item
+    // that is not less than item, or end() if
+    // there is none.
+
+    const_iterator upperBound(const elemType& item) const;
+    //Postcondition: Returns an iterator to the smallest item
+    // that is greater than item, or end() if
+    // there is none.
+
+    const_iterator successor(const elemType& item) const;
+    //Postcondition: Returns an iterator to the next item after
+    // item in inorder sequence (item does not have
+    // to be in the tree), or end() if there is none.
+
+    const_iterator predecessor(const elemType& item) const;
+    //Postcondition: Returns an iterator to the largest item
+    // that is less than item, or end() if there
+    // is none.
+
+    template <class keyType, class compare = compareType,
+              class = typename compare::is_transparent>
+    int rank(const keyType& key) const;
+    template <class keyType, class compare = compareType,
+              class = typename compare::is_transparent>
+    int countRange(const keyType& lowKey, const keyType& highKey) const;
+    template <class keyType, class compare = compareType,
+              class = typename compare::is_transparent>
+    const_iterator lowerBound(const keyType& key) const;
+    template <class keyType, class compare = compareType,
+              class = typename compare::is_transparent>
+    const_iterator upperBound(const keyType& key) const;
+    //Versions of the above for keys of another type than
+    //elemType; only available when compareType is transparent.
+
+    const_iterator findMin() const;
+    const_iterator findMax() const;
+    //Postcondition: Return an iterator to the smallest
+    // (largest) item, or end() if the tree is empty.
+    //All of the above take O(height) time.
+
+    template <class visitor>
+    void rangeVisit(const elemType& lowItem, const elemType& highItem, visitor&& visit);
+    template <class visitor>
+    void rangeVisit(const elemType& lowItem, const elemType& highItem, visitor&& visit) const;
+    //Function to visit, in inorder sequence, the items x with
+    //lowItem <= x <= highItem. Subtrees that lie outside the
+    //range are not entered, so the cost is O(height + k) for
+    //k items in the range. The const version calls visit
+    //with a const elemType&.
+    //Postcondition: visit is applied to each item in the range.
+
+    template <class inputIterator>
+    void buildTree(inputIterator first, inputIterator last);
+    //Function to replace the tree by a perfectly balanced
+    //binary search tree holding the items in [first, last).
+    //The range does not have to be sorted; duplicates are
+    //dropped. The nodes are reserved from the allocator in
+    //one request, so with nodePoolAllocator they occupy a
+    //single contiguous block.
+    //Postcondition: The tree holds every distinct item of
+    // the range and its height is the smallest
+    // possible for that number of nodes. The
+    // previous nodes are destroyed.
+
+    template <class inputIterator>
+    int insertBatch(inputIterator first, inputIterator last);
+    //Function to insert the items in [first, last), which do
+    //not have to be sorted. The batch is sorted and merged into
+    //the tree in one descent: each node is visited once for the
+    //whole batch, not once per item, and the items that fall
+    //into the same empty link are built there as a perfectly
+    //balanced subtree, with their nodes reserved from the
+    //allocator in one request.
+    //Postcondition: Every item of the range is in the tree;
+    // returns the number of items inserted. Items
+    // already in the tree are skipped without
+    // reporting insertDuplicate.
+
+    template <class inputIterator>
+    int deleteBatch(inputIterator first, inputIterator last);
+    //Function to delete the items in [first, last) in one
+    //descent, as insertBatch.
+    //Postcondition: None of the items is in the tree; returns
+    // the number of items deleted. Items not in the
+    // tree are skipped without reporting
+    // deleteNotFound.
+
+    bool split(const elemType& splitItem, bSearchTreeType<elemType, allocType, compareType>& greaterTree);
+    //Function to split the tree at splitItem along its search
+    //path, in O(height) time. The nodes are not copied.
+    //Postcondition: This tree keeps the items less than
+    // splitItem and greaterTree, whose previous
+    // items are destroyed, gets the others. Returns
+    // true if splitItem was in the tree.
+
+    bool join(bSearchTreeType<elemType, allocType, compareType>& greaterTree);
+    //Function to append greaterTree, whose items must all be
+    //greater than those of this tree, in O(height) time.
+    //Postcondition: If the order holds, this tree holds the
+    // items of both trees, greaterTree is empty and
+    // true is returned; otherwise, both trees are
+    // unchanged and false is returned.
+
+    int unionWith(bSearchTreeType<elemType, allocType, compareType>& otherTree);
+    //Function to add the items of otherTree to this tree. The
+    //nodes of otherTree are moved into this tree, not copied.
+    //Postcondition: otherTree is empty; returns the number of
+    // items added (those of otherTree already here
+    // are deleted).
+    int intersectWith(const bSearchTreeType<elemType, allocType, compareType>& otherTree);
+    int differenceWith(const bSearchTreeType<elemType, allocType, compareType>& otherTree);
+    //Functions to delete the items that are not in (in)
+    //otherTree from this tree.
+    //Postcondition: Returns the number of items deleted;
+    // otherTree is unchanged.
+    //unionWith and intersectWith are a linear merge of the two
+    //inorder sequences of nodes, in O(n + m) time, after which
+    //the nodes kept are relinked into a perfectly balanced
+    //tree; if otherTree is much smaller, unionWith links its
+    //nodes in one at a time instead. differenceWith deletes the
+    //items of otherTree one at a time, without reporting
+    //deleteNotFound. Both trees must
+    //be in the same order. Nodes move between trees only if
+    //the allocator lets them: those of a nodePoolAllocator
+    //belong to its blocks, so split, join and unionWith move
+    //their items into new nodes of the receiving tree instead.
+
+    bool saveTree(const char* fileName) const;
+    //Function to write the items to the file fileName in the
+    //binary format of treeFileFormat.h. elemType must be
+    //trivially copyable. The items are written in the order
+    //of compareType, which a mappedSearchTreeType of the file
+    //must take as well.
+    //Postcondition: Returns true if the whole file was written.
+
+    bool loadTree(const char* fileName);
+    //Function to replace the tree by the items of a file written
+    //by saveTree. The items are already sorted, so the tree is
+    //rebuilt as with buildTree without sorting or inserting.
+    //Postcondition: Returns true if the file was read; false
+    // if it could not be read, was written for
+    // another item type, is truncated, fails its
+    // checksum or is not in ascending order, in
+    // which case the tree is unchanged.
+
+    const compareType& keyCompare() const;
+    //Postcondition: Returns the comparator of the tree.
+
+    template <class inputIterator>
+    bSearchTreeType(inputIterator first, inputIterator last,
+                    const compareType& compare = compareType());
+    //Constructor that builds the tree from [first, last)
+    //with buildTree, ordered by compare.
+
+    explicit bSearchTreeType(const compareType& compare);
+    //Constructor of an empty tree ordered by compare.
+
+    bSearchTreeType();
+    //Default constructor
+
+protected:
+    template <class leftType, class rightType>
+    int compareItems(const leftType& a, const rightType& b) const;
+    //Postcondition: Returns a value less than, equal to or
+    // greater than 0 if a is less than, equivalent
+    // to or greater than b in the order of comp.
+
+    template <class keyType>
+    bool searchKey(const keyType& searchItem) const;
+    //Function to do search for an item or a key.
+
+    template <class keyType>
+    bool deleteKey(const keyType& deleteItem);
+    //Function to do deleteNode for an item or a key.
+
+    template <class inputIterator>
+    void sortedItems(inputIterator first, inputIterator last, vector<elemType>& items) const;
+    //Postcondition: items holds the distinct items of
+    // [first, last) in ascending order.
+
+    size_t splitBatch(const vector<elemType>& items, size_t first, size_t last,
+                      const elemType& item, bool& found) const;
+    //Function to find where item divides the sorted
+    //items[first..last-1].
+    //Postcondition: Returns the index of the first item not
+    // less than item; found is true if that item is
+    // equivalent to item.
+
+    nodeType<elemType>* buildBalanced(vector<elemType>& items, size_t first, size_t last);
+    //Function to build a perfectly balanced tree from the
+    //sorted, duplicate-free items[first..last-1].
+    //Postcondition: Returns a pointer to the root of the
+    // tree; every node has its height and size set.
+
+    void inorderNodes(nodeType<elemType> *p, vector<nodeType<elemType>*>& nodes) const;
+    //Postcondition: The nodes of the tree to which p points are
+    // appended to nodes in inorder sequence.
+
+    nodeType<elemType>* linkBalanced(vector<nodeType<elemType>*>& nodes,
+                                     size_t first, size_t last);
+    //Function to link the nodes[first..last-1], in inorder
+    //sequence, into a perfectly balanced tree.
+    //Postcondition: Returns its root; heights and sizes are set.
+
+    nodeType<elemType>* adoptTree(nodeType<elemType> *p, allocType& from);
+    //Function to take over the tree to which p points, whose
+    //nodes were allocated by from.
+    //Postcondition: Returns p if the nodes can be shared between
+    // allocators; otherwise, the items are moved into
+    // a perfectly balanced tree of nodes of this
+    // tree's allocator, whose root is returned, and
+    // the old nodes are given back to from.
+
+    void freeNodes(nodeType<elemType> *p);
+    //Postcondition: The nodes of the tree to which p points are
+    // deallocated.
+
+    template <class keyType>
+    int countLess(const keyType& item, bool orEqual) const;
+    //Postcondition: Returns the number of items less than item,
+    // or less than or equal to item if orEqual is
+    // true.
+
+    template <class keyType>
+    const_iterator firstAfter(const keyType& item, bool orEqual) const;
+    //Postcondition: Returns an iterator to the smallest item
+    // greater than item (or equal to it if orEqual
+    // is true), or end() if there is none.
+
+    template <class keyType>
+    const_iterator lastBefore(const keyType& item, bool orEqual) const;
+    //Postcondition: Returns an iterator to the largest item
+    // less than item (or equal to it if orEqual is
+    // true), or end() if there is none.
+
+    template <class visitor>
+    void rangeVisit(nodeType<elemType> *p, const elemType& lowItem,
+                    const elemType& highItem, visitor& visit) const;
+    //Function to do the range visit of the binary search tree
+    //to which p points.
+
+    template <class keyType>
+    nodeType<elemType>** findLink(const keyType& item);
+    //Function to find the link that points, or would point, to
+    //the node holding item.
+    //Postcondition: Returns the address of that link; the link
+    // is nullptr if item is not in the tree.
+
+    static const int maxPath = 64;      // Nodes kept by findPath
+
+    template <class keyType>
+    nodeType<elemType>** findPath(const keyType& item, nodeType<elemType>* *path, int& depth);
+    //Function to find the link as findLink does, for a caller
+    //that learns only afterwards whether the sizes change.
+    //Postcondition: depth is the number of nodes passed and
+    // path[0..maxPath-1] holds the first of them.
+
+    template <class keyType>
+    void updatePath(nodeType<elemType>* *path, int depth, const keyType& item, int change);
+    //Function to add change to the size of every node passed
+    //by findPath; a path deeper than maxPath is walked again
+    //by updateSizes.
+
+    template <class itemType>
+    bool insertUnique(itemType&& item);
+    //Function to do insert for a copied or moved item.
+
+    template <class keyType>
+    void updateSizes(const keyType& item, int change);
+    //Function to add change to the size of every node on the
+    //path from the root to the node holding item.
+    //Postcondition: The sizes on the path are updated; the node
+    // holding item (if any) is not changed.
+
+    compareType comp;                   // Order of the keys
+
 private:
+    struct batchTask
+    {
+        nodeType<elemType>* *link;      // Link to the subtree
+        size_t first;                   // Items of the batch that
+        size_t last;                    // fall into the subtree
+        bool childrenDone;              // The subtrees were merged
+        bool found;                     // The root holds an item
+    };                                  // of the batch
+
+    static bool mergeCheaper(size_t n, size_t m);
+    //Postcondition: Returns true if merging a tree of m items
+    // into one of n items costs less than m single
+    // searches.
+
     void deleteFromTree(nodeType<elemType>* &p);
     //Function to delete the node to which p points is
     //deleted from the binary search tree.
@@ -48,13 +409,895 @@ private:
     // deleted from the binary search tree.
 };
 
-template <class elemType>
-bool bSearchTreeType<elemType>::search(const elemType& searchItem) const
+template <class elemType, class allocType, class compareType>
+bSearchTreeType<elemType, allocType, compareType>::bSearchTreeType()
+{
+}
+
+template <class elemType, class allocType, class compareType>
+bSearchTreeType<elemType, allocType, compareType>::bSearchTreeType(const compareType& compare)
+    : comp(compare)
+{
+}
+
+template <class elemType, class allocType, class compareType>
+template <class inputIterator>
+bSearchTreeType<elemType, allocType, compareType>::bSearchTreeType(inputIterator first, inputIterator last,
+                const compareType& compare)
+    : comp(compare)
+{
+    buildTree(first, last);
+}
+
+template <class elemType, class allocType, class compareType>
+const compareType& bSearchTreeType<elemType, allocType, compareType>::keyCompare() const
+{
+    return comp;
+}
+
+template <class elemType, class allocType, class compareType>
+template <class leftType, class rightType>
+int bSearchTreeType<elemType, allocType, compareType>::compareItems(const leftType& a, const rightType& b) const
+{
+    return treeCompare(comp, a, b);
+}
+
+template <class elemType, class allocType, class compareType>
+template <class inputIterator>
+void bSearchTreeType<elemType, allocType, compareType>::buildTree(inputIterator first, inputIterator last)
+// Building the tree from a sorted array takes a single pass: the
+// middle item becomes the root and the two halves become the left
+// and right subtrees. This is O(n) after the (skipped when already
+// sorted) O(n log n) sort, instead of n calls to insert.
+{
+    vector<elemType> items;
+
+    sortedItems(first, last, items);
+    this->destroyTree();
+    this->alloc.reserve(items.size());
+    this->root = buildBalanced(items, 0, items.size());
+} //end buildTree
+
+template <class elemType, class allocType, class compareType>
+template <class inputIterator>
+void bSearchTreeType<elemType, allocType, compareType>::sortedItems(inputIterator first, inputIterator last,
+                vector<elemType>& items) const
+{
+    items.assign(first, last);
+    if (!is_sorted(items.begin(), items.end(), comp))
+        sort(items.begin(), items.end(), comp);
+    items.erase(unique(items.begin(), items.end(),
+                       [this](const elemType& a, const elemType& b) { return !comp(a, b); }),
+                items.end());
+} //end sortedItems
+
+template <class elemType, class allocType, class compareType>
+size_t bSearchTreeType<elemType, allocType, compareType>::splitBatch(const vector<elemType>& items, size_t first,
+                size_t last, const elemType& item, bool& found) const
+{
+    size_t split = lower_bound(items.begin() + first, items.begin() + last, item, comp)
+                   - items.begin();
+
+    found = (split < last && compareItems(items[split], item) == 0);
+    return split;
+} //end splitBatch
+
+template <class elemType, class allocType, class compareType>
+template <class inputIterator>
+int bSearchTreeType<elemType, allocType, compareType>::insertBatch(inputIterator first, inputIterator last)
+// The tasks are done in postorder with an explicit stack, since a
+// tree that is not balanced can be too deep for recursion: a task
+// first pushes itself back, marked childrenDone, and then the tasks
+// of the subtrees that receive items; when it comes up again the
+// size of its node is recomputed.
+{
+    vector<elemType> items;
+    vector<batchTask> stack;
+    int oldCount = this->nodeCount(this->root);
+
+    sortedItems(first, last, items);
+    if (!items.empty())
+        stack.push_back({&this->root, 0, items.size(), false, false});
+    while (!stack.empty())
+    {
+        batchTask task = stack.back();
+        nodeType<elemType> *p = *task.link;
+        size_t split;
+
+        stack.pop_back();
+        if (p == nullptr)
+        {
+            this->alloc.reserve(task.last - task.first);
+            *task.link = buildBalanced(items, task.first, task.last);
+        }
+        else if (task.childrenDone)
+            p->size = 1 + this->nodeCount(p->lLink) + this->nodeCount(p->rLink);
+        else
+        {
+            split = splitBatch(items, task.first, task.last, p->info, task.found);
+            task.childrenDone = true;
+            stack.push_back(task);
+            if (split > task.first)
+                stack.push_back({&p->lLink, task.first, split, false, false});
+            if (split + task.found < task.last)
+                stack.push_back({&p->rLink, split + task.found, task.last, false, false});
+        }
+    }
+    return this->nodeCount(this->root) - oldCount;
+} //end insertBatch
+
+template <class elemType, class allocType, class compareType>
+template <class inputIterator>
+int bSearchTreeType<elemType, allocType, compareType>::deleteBatch(inputIterator first, inputIterator last)
+// Same postorder as insertBatch; a node of the batch is deleted
+// once both of its subtrees are done, so the links on the stack
+// below it stay valid.
+{
+    vector<elemType> items;
+    vector<batchTask> stack;
+    int oldCount = this->nodeCount(this->root);
+
+    sortedItems(first, last, items);
+    if (!items.empty())
+        stack.push_back({&this->root, 0, items.size(), false, false});
+    while (!stack.empty())
+    {
+        batchTask task = stack.back();
+        nodeType<elemType> *p = *task.link;
+        size_t split;
+
+        stack.pop_back();
+        if (p == nullptr)
+            continue;
+        else if (task.childrenDone)
+        {
+            p->size = 1 + this->nodeCount(p->lLink) + this->nodeCount(p->rLink);
+            if (task.found)
+                deleteFromTree(*task.link);
+        }
+        else
+        {
+            split = splitBatch(items, task.first, task.last, p->info, task.found);
+            task.childrenDone = true;
+            stack.push_back(task);
+            if (split > task.first)
+                stack.push_back({&p->lLink, task.first, split, false, false});
+            if (split + task.found < task.last)
+                stack.push_back({&p->rLink, split + task.found, task.last, false, false});
+        }
+    }
+    return oldCount - this->nodeCount(this->root);
+} //end deleteBatch
+
+template <class elemType, class allocType, class compareType>
+bool bSearchTreeType<elemType, allocType, compareType>::split
+                (const elemType& splitItem, bSearchTreeType<elemType, allocType, compareType>& greaterTree)
+// The search path is cut into two chains: a node less than splitItem
+// goes to the less side with its left subtree and hangs at the right
+// link of the previous node there, and a node not less goes to the
+// other side with its right subtree. The sizes of the nodes of both
+// chains are recomputed from the bottom up.
+{
+    nodeType<elemType> *p = this->root;
+    nodeType<elemType> *lessRoot = nullptr, *greaterRoot = nullptr;
+    nodeType<elemType>* *lessLink = &lessRoot;
+    nodeType<elemType>* *greaterLink = &greaterRoot;
+    vector<nodeType<elemType>*> path;
+    bool found = false;
+
+    if (&greaterTree == this)
+        return search(splitItem);
+
+    while (p != nullptr)
+    {
+        int order = compareItems(p->info, splitItem);
+
+        path.push_back(p);
+        if (order < 0)
+        {
+            *lessLink = p;
+            lessLink = &p->rLink;
+            p = p->rLink;
+        }
+        else
+        {
+            *greaterLink = p;
+            greaterLink = &p->lLink;
+            p = p->lLink;
+            if (order == 0)
+            {
+                found = true;
+                break;
+            }
+        }
+    }
+    *lessLink = p;
+    *greaterLink = nullptr;
+
+    for (size_t i = path.size(); i > 0; i--)
+    {
+        nodeType<elemType> *q = path[i - 1];
+
+        q->size = 1 + this->nodeCount(q->lLink) + this->nodeCount(q->rLink);
+    }
+
+    greaterTree.destroyTree();
+    greaterTree.root = greaterTree.adoptTree(greaterRoot, this->alloc);
+    this->root = lessRoot;
+    return found;
+} //end split
+
+template <class elemType, class allocType, class compareType>
+bool bSearchTreeType<elemType, allocType, compareType>::join
+                (bSearchTreeType<elemType, allocType, compareType>& greaterTree)
+{
+    nodeType<elemType> *last = this->root;
+    nodeType<elemType> *first = greaterTree.root;
+    nodeType<elemType> *p;
+    int added;
+
+    if (&greaterTree == this)
+        return (this->root == nullptr);
+    if (first == nullptr)
+        return true;
+    if (last != nullptr)
+    {
+        while (last->rLink != nullptr)
+            last = last->rLink;
+        while (first->lLink != nullptr)
+            first = first->lLink;
+        if (compareItems(last->info, first->info) >= 0)
+            return false;
+    }
+
+    p = adoptTree(greaterTree.root, greaterTree.alloc);
+    greaterTree.root = nullptr;
+    added = this->nodeCount(p);
+    if (this->root == nullptr)
+        this->root = p;
+    else
+    {
+        for (nodeType<elemType> *q = this->root; q != last; q = q->rLink)
+            q->size += added;
+        last->rLink = p;
+        last->size += added;
+    }
+    return true;
+} //end join
+
+template <class elemType, class allocType, class compareType>
+int bSearchTreeType<elemType, allocType, compareType>::unionWith
+                (bSearchTreeType<elemType, allocType, compareType>& otherTree)
+// Of two equivalent items, the node of this tree is kept. A few
+// nodes are linked in one at a time instead.
+{
+    vector<nodeType<elemType>*> mine, theirs, result;
+    size_t i = 0, j = 0;
+
+    if (&otherTree == this)
+        return 0;
+    inorderNodes(adoptTree(otherTree.root, otherTree.alloc), theirs);
+    otherTree.root = nullptr;
+    if (!mergeCheaper(this->nodeCount(this->root), theirs.size()))
+    {
+        int added = 0;
+
+        for (j = 0; j < theirs.size(); j++)
+        {
+            nodeType<elemType> *q = theirs[j];
+            nodeType<elemType> *path[maxPath];
+            int depth;
+            nodeType<elemType>* *link = findPath(q->info, path, depth);
+
+            if (*link != nullptr)
+                this->alloc.deallocate(q);
+            else
+            {
+                q->lLink = q->rLink = nullptr;
+                q->height = q->size = 1;
+                *link = q;
+                updatePath(path, depth, q->info, 1);
+                added++;
+            }
+        }
+        return added;
+    }
+    inorderNodes(this->root, mine);
+
+    result.reserve(mine.size() + theirs.size());
+    while (i < mine.size() && j < theirs.size())
+    {
+        int order = compareItems(mine[i]->info, theirs[j]->info);
+
+        if (order < 0)
+            result.push_back(mine[i++]);
+        else if (order > 0)
+            result.push_back(theirs[j++]);
+        else
+        {
+            result.push_back(mine[i++]);
+            this->alloc.deallocate(theirs[j++]);
+        }
+    }
+    result.insert(result.end(), mine.begin() + i, mine.end());
+    result.insert(result.end(), theirs.begin() + j, theirs.end());
+    this->root = linkBalanced(result, 0, result.size());
+    return static_cast<int>(result.size() - mine.size());
+} //end unionWith
+
+template <class elemType, class allocType, class compareType>
+int bSearchTreeType<elemType, allocType, compareType>::intersectWith
+                (const bSearchTreeType<elemType, allocType, compareType>& otherTree)
+{
+    vector<nodeType<elemType>*> mine, theirs, result;
+    size_t j = 0;
+
+    if (&otherTree == this)
+        return 0;
+    inorderNodes(this->root, mine);
+    otherTree.inorderNodes(otherTree.root, theirs);
+
+    for (size_t i = 0; i < mine.size(); i++)
+    {
+        int order = 1;
+
+        while (j < theirs.size() && (order = compareItems(theirs[j]->info, mine[i]->info)) < 0)
+            j++;
+        if (j < theirs.size() && order == 0)
+            result.push_back(mine[i]);
+        else
+            this->alloc.deallocate(mine[i]);
+    }
+    this->root = linkBalanced(result, 0, result.size());
+    return static_cast<int>(mine.size() - result.size());
+} //end intersectWith
+
+template <class elemType, class allocType, class compareType>
+int bSearchTreeType<elemType, allocType, compareType>::differenceWith
+                (const bSearchTreeType<elemType, allocType, compareType>& otherTree)
+// Each item of otherTree is deleted on its own: unlike a union, a
+// merge would have to walk and relink the whole tree to delete at
+// most m nodes, which took longer than m searches even for m = n.
+{
+    int deleted = 0;
+
+    if (&otherTree == this)
+    {
+        deleted = this->nodeCount(this->root);
+        this->destroyTree();
+        return deleted;
+    }
+    otherTree.inorderTraversal([this, &deleted](const elemType& item)
+    {
+        nodeType<elemType> *path[maxPath];
+        int depth;
+        nodeType<elemType>* *link = findPath(item, path, depth);
+
+        if (*link != nullptr)
+        {
+            updatePath(path, depth, item, -1);
+            deleteFromTree(*link);
+            deleted++;
+        }
+    });
+    return deleted;
+} //end differenceWith
+
+template <class elemType, class allocType, class compareType>
+bool bSearchTreeType<elemType, allocType, compareType>::mergeCheaper(size_t n, size_t m)
+// A merge touches all n + m nodes, which costs about as much as
+// m / 4 searches of log2(n) nodes.
+{
+    size_t bits = 0;
+
+    for (size_t k = n; k > 0; k >>= 1)
+        bits++;
+    return (m * bits >= 4 * n);
+} //end mergeCheaper
+
+template <class elemType, class allocType, class compareType>
+void bSearchTreeType<elemType, allocType, compareType>::inorderNodes
+                (nodeType<elemType> *p, vector<nodeType<elemType>*>& nodes) const
+{
+    vector<nodeType<elemType>*> stack;
+
+    while (p != nullptr || !stack.empty())
+    {
+        while (p != nullptr)
+        {
+            stack.push_back(p);
+            p = p->lLink;
+        }
+        p = stack.back();
+        stack.pop_back();
+        nodes.push_back(p);
+        p = p->rLink;
+    }
+} //end inorderNodes
+
+template <class elemType, class allocType, class compareType>
+nodeType<elemType>* bSearchTreeType<elemType, allocType, compareType>::linkBalanced
+                (vector<nodeType<elemType>*>& nodes, size_t first, size_t last)
+{
+    nodeType<elemType> *p;
+    size_t mid;
+    int lHeight, rHeight;
+
+    if (first == last)
+        return nullptr;
+
+    mid = first + (last - first) / 2;
+    p = nodes[mid];
+    p->lLink = linkBalanced(nodes, first, mid);
+    p->rLink = linkBalanced(nodes, mid + 1, last);
+
+    lHeight = (p->lLink == nullptr) ? 0 : p->lLink->height;
+    rHeight = (p->rLink == nullptr) ? 0 : p->rLink->height;
+    p->height = 1 + (lHeight >= rHeight ? lHeight : rHeight);
+    p->size = static_cast<int>(last - first);
+    return p;
+} //end linkBalanced
+
+template <class elemType, class allocType, class compareType>
+nodeType<elemType>* bSearchTreeType<elemType, allocType, compareType>::adoptTree
+                (nodeType<elemType> *p, allocType& from)
+// An allocator that can release all of its nodes at once owns them,
+// so they cannot outlive it in another tree.
+{
+    if constexpr (!allocType::bulkRelease)
+        return p;
+    else
+    {
+        vector<nodeType<elemType>*> nodes;
+
+        if (&from == &this->alloc)
+            return p;
+        inorderNodes(p, nodes);
+        this->alloc.reserve(nodes.size());
+        for (size_t i = 0; i < nodes.size(); i++)
+        {
+            nodeType<elemType> *old = nodes[i];
+
+            nodes[i] = this->alloc.allocate(std::move(old->info));
+            from.deallocate(old);
+        }
+        return linkBalanced(nodes, 0, nodes.size());
+    }
+} //end adoptTree
+
+template <class elemType, class allocType, class compareType>
+void bSearchTreeType<elemType, allocType, compareType>::freeNodes(nodeType<elemType> *p)
+{
+    vector<nodeType<elemType>*> stack;
+
+    if (p != nullptr)
+        stack.push_back(p);
+    while (!stack.empty())
+    {
+        p = stack.back();
+        stack.pop_back();
+        if (p->lLink != nullptr)
+            stack.push_back(p->lLink);
+        if (p->rLink != nullptr)
+            stack.push_back(p->rLink);
+        this->alloc.deallocate(p);
+    }
+} //end freeNodes
+
+template <class elemType, class allocType, class compareType>
+bool bSearchTreeType<elemType, allocType, compareType>::saveTree(const char* fileName) const
+// The items are written in inorder sequence through a buffer of a
+// multiple of 8 items, so the checksum can be computed one buffer at
+// a time; the header is written again once the checksum is known.
+{
+    static_assert(is_trivially_copyable<elemType>::value,
+                  "saveTree needs a trivially copyable elemType");
+    const size_t bufferItems = 8192;
+    ofstream out(fileName, ios::binary | ios::trunc);
+    treeFileHeader header;
+    vector<elemType> buffer;
+    uint64_t hash = treeChecksumSeed;
+
+    if (!out)
+        return false;
+
+    memcpy(header.magic, treeFileMagic, sizeof(treeFileMagic));
+    header.version = treeFileVersion;
+    header.itemSize = sizeof(elemType);
+    header.count = this->nodeCount(this->root);
+    header.checksum = 0;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    auto flush = [&]()
+    {
+        hash = treeChecksum(buffer.data(), buffer.size() * sizeof(elemType), hash);
+        out.write(reinterpret_cast<const char*>(buffer.data()), buffer.size() * sizeof(elemType));
+        buffer.clear();
+    };
+    auto writeItem = [&](const elemType& item)
+    {
+        buffer.push_back(item);
+        if (buffer.size() == bufferItems)
+            flush();
+    };
+
+    buffer.reserve(bufferItems);
+    this->inorderTraversal(writeItem);
+    flush();
+
+    header.checksum = hash;
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.close();
+    return !out.fail();
+} //end saveTree
+
+template <class elemType, class allocType, class compareType>
+bool bSearchTreeType<elemType, allocType, compareType>::loadTree(const char* fileName)
+{
+    static_assert(is_trivially_copyable<elemType>::value,
+                  "loadTree needs a trivially copyable elemType");
+    ifstream in(fileName, ios::binary);
+    treeFileHeader header;
+    vector<elemType> items;
+    streamoff fileBytes;
+
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || !validTreeHeader(header, sizeof(elemType))
+        || header.count > static_cast<uint64_t>(INT_MAX))
+        return false;
+
+    // A damaged count must not size the vector before the file is
+    // known to hold that many items.
+    in.seekg(0, ios::end);
+    fileBytes = in.tellg();
+    if (fileBytes < static_cast<streamoff>(sizeof(header))
+        || header.count > static_cast<uint64_t>(fileBytes - sizeof(header)) / sizeof(elemType))
+        return false;
+    in.seekg(sizeof(header), ios::beg);
+
+    items.resize(header.count);
+    if (!in.read(reinterpret_cast<char*>(items.data()), header.count * sizeof(elemType)))
+        return false;
+    if (treeChecksum(items.data(), header.count * sizeof(elemType)) != header.checksum)
+        return false;
+    for (size_t i = 1; i < items.size(); i++)
+        if (!comp(items[i - 1], items[i]))
+            return false;
+
+    this->destroyTree();
+    this->alloc.reserve(items.size());
+    this->root = buildBalanced(items, 0, items.size());
+    return true;
+} //end loadTree
+
+template <class elemType, class allocType, class compareType>
+nodeType<elemType>* bSearchTreeType<elemType, allocType, compareType>::buildBalanced
+                (vector<elemType>& items, size_t first, size_t last)
+{
+    nodeType<elemType> *p;
+    size_t mid;
+    int lHeight, rHeight;
+
+    if (first == last)
+        return nullptr;
+
+    mid = first + (last - first) / 2;
+    p = this->alloc.allocate(std::move(items[mid]));
+    p->lLink = buildBalanced(items, first, mid);
+    p->rLink = buildBalanced(items, mid + 1, last);
+
+    lHeight = (p->lLink == nullptr) ? 0 : p->lLink->height;
+    rHeight = (p->rLink == nullptr) ? 0 : p->rLink->height;
+    p->height = 1 + (lHeight >= rHeight ? lHeight : rHeight);
+    p->size = static_cast<int>(last - first);
+    return p;
+} //end buildBalanced
+
+template <class elemType, class allocType, class compareType>
+template <class keyType>
+void bSearchTreeType<elemType, allocType, compareType>::updateSizes(const keyType& item, int change)
+{
+    nodeType<elemType> *current = this->root;
+    int order;
+
+    while (current != nullptr)
+    {
+        TREE_STATS_COMPARE();
+        order = compareItems(current->info, item);
+        if (order == 0)
+            break;
+        current->size += change;
+        if (order > 0)
+            current = current->lLink;
+        else
+            current = current->rLink;
+    }
+} //end updateSizes
+
+template <class elemType, class allocType, class compareType>
+template <class keyType>
+int bSearchTreeType<elemType, allocType, compareType>::countLess(const keyType& item, bool orEqual) const
+// Every time the search moves right, the node and its whole left
+// subtree are less than item.
+{
+    nodeType<elemType> *current = this->root;
+    int count = 0;
+    int order;
+
+    while (current != nullptr)
+    {
+        order = compareItems(current->info, item);
+        if (order == 0)
+        {
+            count += this->nodeCount(current->lLink) + (orEqual ? 1 : 0);
+            break;
+        }
+        else if (order > 0)
+            current = current->lLink;
+        else
+        {
+            count += this->nodeCount(current->lLink) + 1;
+            current = current->rLink;
+        }
+    }
+    return count;
+} //end countLess
+
+template <class elemType, class allocType, class compareType>
+int bSearchTreeType<elemType, allocType, compareType>::rank(const elemType& item) const
+{
+    return countLess(item, false);
+}
+
+template <class elemType, class allocType, class compareType>
+int bSearchTreeType<elemType, allocType, compareType>::countRange(const elemType& lowItem, const elemType& highItem) const
+{
+    if (compareItems(lowItem, highItem) > 0)
+        return 0;
+    else
+        return countLess(highItem, true) - countLess(lowItem, false);
+}
+
+template <class elemType, class allocType, class compareType>
+typename bSearchTreeType<elemType, allocType, compareType>::const_iterator
+bSearchTreeType<elemType, allocType, compareType>::select(int k) const
+// The left subtree of a node holds the nodeCount(lLink) smallest
+// items of its subtree, so comparing k with it tells which way to go.
+{
+    vector<nodeType<elemType>*> path;
+    nodeType<elemType> *current = this->root;
+    int leftSize;
+
+    if (k < 0 || k >= this->nodeCount(this->root))
+        return this->end();
+
+    while (current != nullptr)
+    {
+        path.push_back(current);
+        leftSize = this->nodeCount(current->lLink);
+        if (k < leftSize)
+            current = current->lLink;
+        else if (k == leftSize)
+            break;
+        else
+        {
+            k -= leftSize + 1;
+            current = current->rLink;
+        }
+    }
+    return const_iterator(this->root, path);
+} //end select
+
+template <class elemType, class allocType, class compareType>
+template <class keyType>
+typename bSearchTreeType<elemType, allocType, compareType>::const_iterator
+bSearchTreeType<elemType, allocType, compareType>::firstAfter(const keyType& item, bool orEqual) const
+// The answer is the last node on the search path where the search
+// turned left, so the path to it is a prefix of the search path.
+{
+    vector<nodeType<elemType>*> path;
+    nodeType<elemType> *current = this->root;
+    size_t found = 0;   // length of the path to the best node so far
+    int order;
+
+    while (current != nullptr)
+    {
+        path.push_back(current);
+        order = compareItems(current->info, item);
+        if (order > 0 || (orEqual && order == 0))
+        {
+            found = path.size();
+            current = current->lLink;
+        }
+        else
+            current = current->rLink;
+    }
+    path.resize(found);
+    return const_iterator(this->root, path);
+} //end firstAfter
+
+template <class elemType, class allocType, class compareType>
+template <class keyType>
+typename bSearchTreeType<elemType, allocType, compareType>::const_iterator
+bSearchTreeType<elemType, allocType, compareType>::lastBefore(const keyType& item, bool orEqual) const
+// Mirror image of firstAfter: the answer is the last node on the
+// search path where the search turned right.
+{
+    vector<nodeType<elemType>*> path;
+    nodeType<elemType> *current = this->root;
+    size_t found = 0;   // length of the path to the best node so far
+    int order;
+
+    while (current != nullptr)
+    {
+        path.push_back(current);
+        order = compareItems(current->info, item);
+        if (order < 0 || (orEqual && order == 0))
+        {
+            found = path.size();
+            current = current->rLink;
+        }
+        else
+            current = current->lLink;
+    }
+    path.resize(found);
+    return const_iterator(this->root, path);
+} //end lastBefore
+
+template <class elemType, class allocType, class compareType>
+typename bSearchTreeType<elemType, allocType, compareType>::const_iterator
+bSearchTreeType<elemType, allocType, compareType>::lowerBound(const elemType& item) const
+{
+    return firstAfter(item, true);
+}
+
+template <class elemType, class allocType, class compareType>
+typename bSearchTreeType<elemType, allocType, compareType>::const_iterator
+bSearchTreeType<elemType, allocType, compareType>::upperBound(const elemType& item) const
+{
+    return firstAfter(item, false);
+}
+
+template <class elemType, class allocType, class compareType>
+typename bSearchTreeType<elemType, allocType, compareType>::const_iterator
+bSearchTreeType<elemType, allocType, compareType>::successor(const elemType& item) const
+{
+    return firstAfter(item, false);
+}
+
+template <class elemType, class allocType, class compareType>
+typename bSearchTreeType<elemType, allocType, compareType>::const_iterator
+bSearchTreeType<elemType, allocType, compareType>::predecessor(const elemType& item) const
+{
+    return lastBefore(item, false);
+}
+
+template <class elemType, class allocType, class compareType>
+template <class keyType, class compare, class>
+int bSearchTreeType<elemType, allocType, compareType>::rank(const keyType& key) const
+{
+    return countLess(key, false);
+}
+
+template <class elemType, class allocType, class compareType>
+template <class keyType, class compare, class>
+int bSearchTreeType<elemType, allocType, compareType>::countRange(const keyType& lowKey, const keyType& highKey) const
+{
+    if (compareItems(lowKey, highKey) > 0)
+        return 0;
+    else
+        return countLess(highKey, true) - countLess(lowKey, false);
+}
+
+template <class elemType, class allocType, class compareType>
+template <class keyType, class compare, class>
+typename bSearchTreeType<elemType, allocType, compareType>::const_iterator
+bSearchTreeType<elemType, allocType, compareType>::lowerBound(const keyType& key) const
+{
+    return firstAfter(key, true);
+}
+
+template <class elemType, class allocType, class compareType>
+template <class keyType, class compare, class>
+typename bSearchTreeType<elemType, allocType, compareType>::const_iterator
+bSearchTreeType<elemType, allocType, compareType>::upperBound(const keyType& key) const
+{
+    return firstAfter(key, false);
+}
+
+template <class elemType, class allocType, class compareType>
+typename bSearchTreeType<elemType, allocType, compareType>::const_iterator
+bSearchTreeType<elemType, allocType, compareType>::findMin() const
+{
+    return this->begin();
+}
+
+template <class elemType, class allocType, class compareType>
+typename bSearchTreeType<elemType, allocType, compareType>::const_iterator
+bSearchTreeType<elemType, allocType, compareType>::findMax() const
+{
+    const_iterator last = this->end();
+
+    if (this->root != nullptr)
+        --last;
+    return last;
+}
+
+template <class elemType, class allocType, class compareType>
+template <class visitor>
+void bSearchTreeType<elemType, allocType, compareType>::rangeVisit(nodeType<elemType> *p, const elemType& lowItem,
+                const elemType& highItem, visitor& visit) const
+// An inorder traversal with an explicit stack that never goes into
+// the left subtree of a node less than lowItem, and stops at the first
+// node greater than highItem, since every node after it is larger.
+{
+    vector<nodeType<elemType>*> stack;
+
+    while (p != nullptr || !stack.empty())
+    {
+        while (p != nullptr)
+        {
+            if (compareItems(p->info, lowItem) < 0)
+                p = p->rLink;
+            else
+            {
+                stack.push_back(p);
+                p = p->lLink;
+            }
+        }
+        if (stack.empty())
+            break;
+        p = stack.back();
+        stack.pop_back();
+        if (compareItems(p->info, highItem) > 0)
+            break;
+        visit(p->info);
+        p = p->rLink;
+    }
+} //end rangeVisit
+
+template <class elemType, class allocType, class compareType>
+template <class visitor>
+void bSearchTreeType<elemType, allocType, compareType>::rangeVisit(const elemType& lowItem, const elemType& highItem,
+                visitor&& visit)
+{
+    rangeVisit(this->root, lowItem, highItem, visit);
+}
+
+template <class elemType, class allocType, class compareType>
+template <class visitor>
+void bSearchTreeType<elemType, allocType, compareType>::rangeVisit(const elemType& lowItem, const elemType& highItem,
+                visitor&& visit) const
+{
+    auto constVisit = [&visit](elemType& item) { visit(static_cast<const elemType&>(item)); };
+
+    rangeVisit(this->root, lowItem, highItem, constVisit);
+}
+
+template <class elemType, class allocType, class compareType>
+bool bSearchTreeType<elemType, allocType, compareType>::search(const elemType& searchItem) const
+{
+    return searchKey(searchItem);
+}
+
+template <class elemType, class allocType, class compareType>
+template <class keyType, class compare, class>
+bool bSearchTreeType<elemType, allocType, compareType>::search(const keyType& key) const
+{
+    return searchKey(key);
+}
+
+template <class elemType, class allocType, class compareType>
+template <class keyType>
+bool bSearchTreeType<elemType, allocType, compareType>::searchKey(const keyType& searchItem) const
 {
     nodeType<elemType> *current;        // Pointer to traverse the binary search tree
     bool found = false;
+    int order;
+    TREE_STATS_BEGIN();
     if (this->root == nullptr)          // If tree is empty.
-        cout << "Cannot search an empty tree." << endl;
+        reportTreeEvent(searchEmptyTree);
     else
     {
         current = this->root;           // Current is initialize to root
@@ -62,145 +1305,280 @@ bool bSearchTreeType<elemType>::search(const elemType& searchItem) const
                                         // at the root node.
         while (current != nullptr && !found)        // traverse the binary tree
         {
-            if (current->info == searchItem)        // compare search item with info in the node
+            TREE_STATS_VISIT();
+            order = compareItems(current->info, searchItem);  // compare search item with info in the node
+            if (order == 0)
                 found = true;
-            else if (current->info > searchItem)
+            else if (order > 0)
                 current = current->lLink;
             else
                 current = current->rLink;
         }//end while
     }//end else
+    TREE_STATS_END(searchOperation, found);
     return found;
-}//end search
+}//end searchKey
 
-template <class elemType>
-void bSearchTreeType<elemType>::insert(const elemType& insertItem)
+template <class elemType, class allocType, class compareType>
+void bSearchTreeType<elemType, allocType, compareType>::searchBatch(const elemType* keys, size_t n, bool* out) const
+// Every search of a group keeps its own current node. Each round
+// moves every unfinished search one level down and prefetches its
+// next node, so a round costs about one memory latency for the whole
+// group rather than one per search.
 {
-    nodeType<elemType> *current; //pointer to traverse the tree
-    nodeType<elemType> *trailCurrent = nullptr; //pointer behind current
-    nodeType<elemType> *newNode; //pointer to create the node
-    newNode = new nodeType<elemType>;
-    newNode->info = insertItem;
-    newNode->lLink = nullptr;
-    newNode->rLink = nullptr;
-    if (this->root == nullptr)      // if root is nullptr, the tree is empty
-                                    // make root point to the new node
-        this->root = newNode;
-    else
+    const size_t groupSize = 16;
+    nodeType<elemType> *current[groupSize];
+    size_t first, count, i;
+    bool active;
+
+    for (first = 0; first < n; first += groupSize)
     {
-        current = this->root;
-        while (current != nullptr)      // search the binary tree
+        count = (n - first < groupSize) ? n - first : groupSize;
+        for (i = 0; i < count; i++)
         {
-            trailCurrent = current;
-            if (current->info == insertItem)
+            current[i] = this->root;
+            out[first + i] = false;
+        }
+
+        active = true;
+        while (active)
+        {
+            active = false;
+            for (i = 0; i < count; i++)
             {
-                cout << "The item to be inserted is already ";
-                cout << "in the tree -- duplicates are not "
-                     << "allowed." << endl;
-                return;
+                nodeType<elemType> *p = current[i];
+                if (p == nullptr)
+                    continue;
+                int order = compareItems(p->info, keys[first + i]);
+                if (order == 0)
+                {
+                    out[first + i] = true;
+                    p = nullptr;
+                }
+                else if (order > 0)
+                    p = p->lLink;
+                else
+                    p = p->rLink;
+                current[i] = p;
+                if (p != nullptr)
+                {
+#if defined(__GNUC__)
+                    __builtin_prefetch(p);
+#endif
+                    active = true;
+                }
             }
-            else if (current->info > insertItem)
-                current = current->lLink;
-            else
-                current = current->rLink;
-        }   // end while
+        }
+    }
+} //end searchBatch
 
-        // Insert the new node in the binary tree
-        if (trailCurrent->info > insertItem)
-            trailCurrent->lLink = newNode;
+template <class elemType, class allocType, class compareType>
+template <class keyType>
+nodeType<elemType>** bSearchTreeType<elemType, allocType, compareType>::findLink(const keyType& item)
+{
+    nodeType<elemType>* *link = &this->root;
+    int order;
+
+    while (*link != nullptr)
+    {
+        TREE_STATS_VISIT();
+        order = compareItems((*link)->info, item);
+        if (order == 0)
+            break;
+        else if (order > 0)
+            link = &(*link)->lLink;
         else
-            trailCurrent->rLink = newNode;
+            link = &(*link)->rLink;
+    }
+    return link;
+} //end findLink
+
+template <class elemType, class allocType, class compareType>
+template <class keyType>
+nodeType<elemType>** bSearchTreeType<elemType, allocType, compareType>::findPath
+                (const keyType& item, nodeType<elemType>* *path, int& depth)
+{
+    nodeType<elemType>* *link = &this->root;
+    int order;
+
+    depth = 0;
+    while (*link != nullptr)
+    {
+        TREE_STATS_VISIT();
+        order = compareItems((*link)->info, item);
+        if (order == 0)
+            break;
+        if (depth < maxPath)
+            path[depth] = *link;
+        depth++;
+        if (order > 0)
+            link = &(*link)->lLink;
+        else
+            link = &(*link)->rLink;
+    }
+    return link;
+} //end findPath
+
+template <class elemType, class allocType, class compareType>
+template <class keyType>
+void bSearchTreeType<elemType, allocType, compareType>::updatePath
+                (nodeType<elemType>* *path, int depth, const keyType& item, int change)
+{
+    if (depth <= maxPath)
+        for (int i = 0; i < depth; i++)
+            path[i]->size += change;
+    else
+        updateSizes(item, change);
+} //end updatePath
+
+template <class elemType, class allocType, class compareType>
+template <class itemType>
+bool bSearchTreeType<elemType, allocType, compareType>::insertUnique(itemType&& item)
+{
+    nodeType<elemType> *path[maxPath];
+    int depth;
+    TREE_STATS_BEGIN();
+    nodeType<elemType>* *link = findPath(item, path, depth);
+
+    if (*link != nullptr)
+    {
+        reportTreeEvent(insertDuplicate);
+        TREE_STATS_END(insertOperation, false);
+        return false;
     }
+
+    // The node is created only once we know the item is not a
+    // duplicate, and the sizes change only once it exists, so an
+    // exception from the copy leaves the tree as it was.
+    *link = this->alloc.allocate(std::forward<itemType>(item));
+    updatePath(path, depth, (*link)->info, 1);
+    TREE_STATS_END(insertOperation, true);
+    return true;
+} //end insertUnique
+
+template <class elemType, class allocType, class compareType>
+bool bSearchTreeType<elemType, allocType, compareType>::insert(const elemType& insertItem)
+{
+    return insertUnique(insertItem);
+}   // end insert
+
+template <class elemType, class allocType, class compareType>
+bool bSearchTreeType<elemType, allocType, compareType>::insert(elemType&& insertItem)
+{
+    return insertUnique(std::move(insertItem));
 }   // end insert
 
-template <class elemType>
-void bSearchTreeType<elemType>::deleteFromTree(nodeType<elemType>* &p)
+template <class elemType, class allocType, class compareType>
+template <class... argTypes>
+bool bSearchTreeType<elemType, allocType, compareType>::emplace(argTypes&&... args)
+{
+    nodeType<elemType> *path[maxPath];
+    int depth;
+    TREE_STATS_BEGIN();
+    nodeType<elemType> *newNode = this->alloc.allocate(std::forward<argTypes>(args)...);
+    nodeType<elemType>* *link = findPath(newNode->info, path, depth);
+
+    if (*link != nullptr)
+    {
+        this->alloc.deallocate(newNode);
+        reportTreeEvent(insertDuplicate);
+        TREE_STATS_END(insertOperation, false);
+        return false;
+    }
+    *link = newNode;
+    updatePath(path, depth, newNode->info, 1);
+    TREE_STATS_END(insertOperation, true);
+    return true;
+} //end emplace
+
+template <class elemType, class allocType, class compareType>
+void bSearchTreeType<elemType, allocType, compareType>::deleteFromTree(nodeType<elemType>* &p)
 {
     nodeType<elemType> *current; //pointer to traverse the tree
     nodeType<elemType> *trailCurrent; //pointer behind current
     nodeType<elemType> *temp; //pointer to delete the node
     if (p == nullptr)
-        cout << "Error: The node to be deleted does not exist."
-             << endl;
+        reportTreeEvent(deleteNotFound);
     else if (p->lLink == nullptr && p->rLink == nullptr)
     {
         temp = p;
         p = nullptr;
-        delete temp;
+        this->alloc.deallocate(temp);
     }
     else if (p->lLink == nullptr)
     {
         temp = p;
         p = temp->rLink;
-        delete temp;
+        this->alloc.deallocate(temp);
     }
     else if (p->rLink == nullptr)
     {
         temp = p;
         p = temp->lLink;
-        delete temp;
+        this->alloc.deallocate(temp);
     }
     else
     {
+        p->size--;
         current = p->lLink;
         trailCurrent = nullptr;
         while (current->rLink != nullptr)
         {
+            TREE_STATS_WALK();
+            current->size--;    // the predecessor is in this subtree
             trailCurrent = current;
             current = current->rLink;
         }//end while
-        p->info = current->info;
+        p->info = std::move(current->info);
         if (trailCurrent == nullptr) //current did not move;
                                      //current == p->lLink; adjust p
             p->lLink = current->lLink;
         else
             trailCurrent->rLink = current->lLink;
-        delete current;
+        this->alloc.deallocate(current);
     }//end else
 } //end deleteFromTree
 
-template <class elemType>
-void bSearchTreeType<elemType>::deleteNode(const elemType& deleteItem)
+template <class elemType, class allocType, class compareType>
+bool bSearchTreeType<elemType, allocType, compareType>::deleteNode(const elemType& deleteItem)
 {
-    nodeType<elemType> *current; //pointer to traverse the tree
-    nodeType<elemType> *trailCurrent; //pointer behind current
+    return deleteKey(deleteItem);
+}
+
+template <class elemType, class allocType, class compareType>
+template <class keyType, class compare, class>
+bool bSearchTreeType<elemType, allocType, compareType>::deleteNode(const keyType& key)
+{
+    return deleteKey(key);
+}
+
+template <class elemType, class allocType, class compareType>
+template <class keyType>
+bool bSearchTreeType<elemType, allocType, compareType>::deleteKey(const keyType& deleteItem)
+{
+    nodeType<elemType>* *link; //link to the node to delete
+    nodeType<elemType> *path[maxPath]; //ancestors of that node
+    int depth;
     bool found = false;
+    TREE_STATS_BEGIN();
     if (this->root == nullptr)
-        cout << "Cannot delete from an empty tree."
-             << endl;
+        reportTreeEvent(deleteEmptyTree);
     else
     {
-        current = this->root;
-        trailCurrent = this->root;
-        while (current != nullptr && !found)
+        link = findPath(deleteItem, path, depth);
+        if (*link == nullptr)
+            reportTreeEvent(deleteNotFound);
+        else
         {
-            if (current->info == deleteItem)
-                found = true;
-            else
-            {
-                trailCurrent = current;
-                if (current->info > deleteItem)
-                    current = current->lLink;
-                else
-                    current = current->rLink;
-            }
-        }//end while
-        if (current == nullptr)
-            cout << "The item to be deleted is not in the tree."
-                 << endl;
-        else if (found)
-        {
-            if (current == this->root)
-                deleteFromTree(this->root);
-            else if (trailCurrent->info > deleteItem)
-                deleteFromTree(trailCurrent->lLink);
-            else
-                deleteFromTree(trailCurrent->rLink);
+            // Before the unlink, so that a path deeper than maxPath
+            // can still be walked to the node.
+            updatePath(path, depth, deleteItem, -1);
+            found = true;
+            deleteFromTree(*link);
         }
-        else
-            cout << "The item to be deleted is not in the tree."
-                 << endl;
     }
-} //end deleteNode
+    TREE_STATS_END(deleteOperation, found);
+    return found;
+} //end deleteKey
 
 #endif
\ No newline at end of file
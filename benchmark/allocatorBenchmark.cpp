@@ -0,0 +1,52 @@
+// Build and tear down an AVL tree with the default new/delete node
+// allocator and with the pool allocator.
+//
+// Usage: allocatorBenchmark [number of keys]
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include "../avlTreeType.h"
+#include "benchmarkTimer.h"
+
+using namespace std;
+
+template <class treeType>
+void runCase(const char* allocName, const vector<int>& keys)
+{
+    treeType tree;
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (size_t i = 0; i < keys.size(); i++)
+        tree.insert(keys[i]);
+    double buildTime = secondsSince(start);
+
+    start = chrono::steady_clock::now();
+    tree.destroyTree();
+    double destroyTime = secondsSince(start);
+
+    cout << left << setw(8) << allocName << right << fixed << setprecision(4)
+         << setw(14) << buildTime << setw(14) << destroyTime << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t n = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 1000000;
+
+    vector<int> keys(n);
+    for (size_t i = 0; i < n; i++)
+        keys[i] = static_cast<int>(i);
+    shuffle(keys.begin(), keys.end(), mt19937(12345));
+
+    cout << "keys: " << n << endl;
+    cout << left << setw(8) << "alloc" << right
+         << setw(14) << "build (s)" << setw(14) << "destroy (s)" << endl;
+    runCase<avlTreeType<int> >("new", keys);
+    runCase<avlTreeType<int, nodePoolAllocator<int> > >("pool", keys);
+
+    return 0;
+}
@@ -0,0 +1,79 @@
+// Compares bPlusTreeType with several node sizes against
+// bSearchTreeType and avlTreeType on the same random int keys:
+// inserting them one by one, searching for random keys (half of them
+// missing) and visiting every key in order.
+//
+// Usage: bPlusBenchmark [number of keys] [number of searches]
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include "../avlTreeType.h"
+#include "../bPlusTreeType.h"
+#include "benchmarkTimer.h"
+
+using namespace std;
+
+template <class treeType>
+void runCase(const char* treeName, const vector<int>& keys, const vector<int>& probes)
+{
+    treeType tree;
+    int found = 0;
+    long long sum = 0;
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (size_t i = 0; i < keys.size(); i++)
+        tree.insert(keys[i]);
+    double insertTime = secondsSince(start);
+
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < probes.size(); i++)
+        found += tree.search(probes[i]);
+    double searchTime = secondsSince(start);
+
+    start = chrono::steady_clock::now();
+    tree.inorderTraversal([&sum](const int& item) { sum += item; });
+    double scanTime = secondsSince(start);
+
+    cout << left << setw(16) << treeName << right << fixed << setprecision(3)
+         << setw(12) << insertTime << setprecision(1)
+         << setw(14) << searchTime * 1e9 / probes.size()
+         << setw(14) << setprecision(2) << scanTime * 1e9 / keys.size() << setw(8) << tree.treeHeight()
+         << (found == static_cast<int>(probes.size() / 2)
+             && sum == static_cast<long long>(keys.size()) * static_cast<long long>(keys.size() - 1) ? "" : "  (result mismatch)")
+         << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t n = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 1000000;
+    size_t searches = (argc > 2) ? strtoul(argv[2], nullptr, 10) : 1000000;
+    mt19937 generator(12345);
+
+    // The tree holds even keys; half the probes are odd and miss.
+    vector<int> keys(n);
+    for (size_t i = 0; i < n; i++)
+        keys[i] = static_cast<int>(2 * i);
+    shuffle(keys.begin(), keys.end(), generator);
+
+    vector<int> probes(searches);
+    for (size_t i = 0; i < searches; i++)
+        probes[i] = static_cast<int>(2 * (generator() % n) + i % 2);
+
+    cout << "keys: " << n << ", searches: " << searches
+         << ", AVX2 node search: " << (bPlusTreeType<int>::vectorSearch() ? "yes" : "no") << endl;
+    cout << left << setw(16) << "tree" << right << setw(12) << "insert (s)"
+         << setw(14) << "search (ns)" << setw(14) << "scan (ns/key)" << setw(8) << "height" << endl;
+    runCase<bSearchTreeType<int> >("bst", keys, probes);
+    runCase<avlTreeType<int> >("avl", keys, probes);
+    runCase<bPlusTreeType<int, less<int>, 64> >("b+ 64 bytes", keys, probes);
+    runCase<bPlusTreeType<int, less<int>, 256> >("b+ 256 bytes", keys, probes);
+    runCase<bPlusTreeType<int, less<int>, 1024> >("b+ 1024 bytes", keys, probes);
+    runCase<bPlusTreeType<int, less<int>, 4096> >("b+ 4096 bytes", keys, probes);
+
+    return 0;
+}
@@ -0,0 +1,73 @@
+// Compares the plain binary search tree with the AVL tree on sorted
+// and random input: tree height, inserts/sec and searches/sec.
+//
+// Usage: balanceBenchmark [number of keys]
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include "../bSearchTreeType.h"
+#include "../avlTreeType.h"
+#include "benchmarkTimer.h"
+
+using namespace std;
+
+void runCase(const char* treeName, const char* inputName,
+             binaryTreeType<int>& tree, const vector<int>& keys)
+{
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (size_t i = 0; i < keys.size(); i++)
+        tree.insert(keys[i]);
+    double insertRate = keys.size() / secondsSince(start);
+
+    size_t found = 0;
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < keys.size(); i++)
+        found += tree.search(keys[i]);
+    double searchRate = keys.size() / secondsSince(start);
+
+    cout << left << setw(8) << treeName << setw(8) << inputName
+         << right << setw(8) << tree.treeHeight()
+         << setw(16) << fixed << setprecision(0) << insertRate
+         << setw(16) << searchRate
+         << (found == keys.size() ? "" : "  (search mismatch)") << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t n = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 20000;
+
+    vector<int> sorted(n);
+    for (size_t i = 0; i < n; i++)
+        sorted[i] = static_cast<int>(i);
+    vector<int> shuffled(sorted);
+    shuffle(shuffled.begin(), shuffled.end(), mt19937(12345));
+
+    cout << "keys: " << n << endl;
+    cout << left << setw(8) << "tree" << setw(8) << "input"
+         << right << setw(8) << "height"
+         << setw(16) << "inserts/sec" << setw(16) << "searches/sec" << endl;
+
+    {
+        bSearchTreeType<int> tree;
+        runCase("bst", "sorted", tree, sorted);
+    }
+    {
+        avlTreeType<int> tree;
+        runCase("avl", "sorted", tree, sorted);
+    }
+    {
+        bSearchTreeType<int> tree;
+        runCase("bst", "random", tree, shuffled);
+    }
+    {
+        avlTreeType<int> tree;
+        runCase("avl", "random", tree, shuffled);
+    }
+
+    return 0;
+}
@@ -0,0 +1,72 @@
+// Lookups/sec of searchBatch against a loop of single-key search, for
+// the pointer tree and for its Eytzinger snapshot.
+//
+// Usage: batchSearchBenchmark [number of keys] [batch size]
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include "../bSearchTreeType.h"
+#include "../eytzingerTreeType.h"
+#include "benchmarkTimer.h"
+
+using namespace std;
+
+template <class treeType>
+void runCase(const char* treeName, const treeType& tree,
+             const vector<int>& queries, size_t batchSize)
+{
+    unique_ptr<bool[]> out(new bool[queries.size()]);
+    size_t singleFound = 0, batchFound = 0;
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (size_t i = 0; i < queries.size(); i++)
+        singleFound += tree.search(queries[i]);
+    double singleRate = queries.size() / secondsSince(start);
+
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < queries.size(); i += batchSize)
+    {
+        size_t n = (queries.size() - i < batchSize) ? queries.size() - i : batchSize;
+        tree.searchBatch(queries.data() + i, n, out.get() + i);
+    }
+    double batchRate = queries.size() / secondsSince(start);
+    for (size_t i = 0; i < queries.size(); i++)
+        batchFound += out[i];
+
+    cout << left << setw(12) << treeName << right << fixed << setprecision(0)
+         << setw(16) << singleRate << setw(16) << batchRate
+         << setprecision(2) << setw(10) << batchRate / singleRate << "x"
+         << (singleFound == batchFound ? "" : "  (result mismatch)") << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t n = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 10000000;
+    size_t batchSize = (argc > 2) ? strtoul(argv[2], nullptr, 10) : 4096;
+
+    vector<int> keys(n);
+    for (size_t i = 0; i < n; i++)
+        keys[i] = static_cast<int>(2 * i);
+    bSearchTreeType<int> tree(keys.begin(), keys.end());
+    eytzingerTreeType<int> snapshot(tree);
+
+    mt19937 gen(12345);
+    uniform_int_distribution<int> dist(0, static_cast<int>(2 * n - 1));
+    vector<int> queries(4000000);
+    for (size_t i = 0; i < queries.size(); i++)
+        queries[i] = dist(gen);
+
+    cout << "keys: " << n << ", batch size: " << batchSize
+         << ", AVX2: " << (eytzingerTreeType<int>::vectorSearch() ? "yes" : "no") << endl;
+    cout << left << setw(12) << "tree" << right << setw(16) << "single/sec"
+         << setw(16) << "batch/sec" << setw(11) << "speedup" << endl;
+    runCase("pointer", tree, queries, batchSize);
+    runCase("eytzinger", snapshot, queries, batchSize);
+
+    return 0;
+}
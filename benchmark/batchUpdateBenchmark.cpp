@@ -0,0 +1,82 @@
+// Compares insertBatch and deleteBatch with a loop of insert and
+// deleteNode over the same keys, for batches of 10K, 100K and 1M random
+// keys merged into a tree of random keys.
+//
+// Usage: batchUpdateBenchmark [number of keys in the tree]
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include "../avlTreeType.h"
+#include "benchmarkTimer.h"
+
+using namespace std;
+
+template <class treeType>
+void runCase(const char* treeName, const vector<int>& keys, const vector<int>& batch)
+{
+    treeType looped(keys.begin(), keys.end());
+    treeType batched(keys.begin(), keys.end());
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (size_t i = 0; i < batch.size(); i++)
+        looped.insert(batch[i]);
+    double loopInsert = secondsSince(start);
+
+    start = chrono::steady_clock::now();
+    batched.insertBatch(batch.begin(), batch.end());
+    double batchInsert = secondsSince(start);
+
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < batch.size(); i++)
+        looped.deleteNode(batch[i]);
+    double loopDelete = secondsSince(start);
+
+    start = chrono::steady_clock::now();
+    batched.deleteBatch(batch.begin(), batch.end());
+    double batchDelete = secondsSince(start);
+
+    cout << left << setw(6) << treeName << right << setw(9) << batch.size()
+         << fixed << setprecision(4)
+         << setw(12) << loopInsert << setw(12) << batchInsert
+         << setprecision(2) << setw(9) << loopInsert / batchInsert << "x"
+         << setprecision(4)
+         << setw(12) << loopDelete << setw(12) << batchDelete
+         << setprecision(2) << setw(9) << loopDelete / batchDelete << "x"
+         << (looped.treeNodeCount() == batched.treeNodeCount() ? "" : "  (result mismatch)")
+         << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t n = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 1000000;
+    const size_t batchSizes[] = {10000, 100000, 1000000};
+    mt19937 generator(12345);
+
+    // The tree holds even keys and the batches odd ones, so every
+    // key of a batch is new.
+    vector<int> keys(n);
+    for (size_t i = 0; i < n; i++)
+        keys[i] = static_cast<int>(2 * i);
+    shuffle(keys.begin(), keys.end(), generator);
+
+    cout << "keys in the tree: " << n << endl;
+    cout << left << setw(6) << "tree" << right << setw(9) << "batch"
+         << setw(12) << "insert (s)" << setw(12) << "batch (s)" << setw(10) << "speedup"
+         << setw(12) << "delete (s)" << setw(12) << "batch (s)" << setw(10) << "speedup" << endl;
+    for (size_t b = 0; b < sizeof(batchSizes) / sizeof(batchSizes[0]); b++)
+    {
+        vector<int> batch(batchSizes[b]);
+        for (size_t i = 0; i < batch.size(); i++)
+            batch[i] = static_cast<int>(2 * (generator() % (2 * n)) + 1);
+
+        runCase<bSearchTreeType<int> >("bst", keys, batch);
+        runCase<avlTreeType<int> >("avl", keys, batch);
+    }
+
+    return 0;
+}
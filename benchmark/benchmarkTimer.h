@@ -0,0 +1,17 @@
+// Timing helper shared by main and the standalone benchmarks.
+#ifndef BENCHMARKTIMER_H
+#define BENCHMARKTIMER_H
+
+#include <chrono>
+
+using namespace std;
+
+inline double secondsSince(chrono::steady_clock::time_point start)
+//Postcondition: Returns the seconds elapsed on the steady clock
+// since start.
+{
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+#endif
@@ -0,0 +1,52 @@
+// Compares building a tree with one insert per key against the
+// single-pass buildTree, on sorted and random keys.
+//
+// Usage: buildBenchmark [number of keys]
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include "../avlTreeType.h"
+#include "benchmarkTimer.h"
+
+using namespace std;
+
+void runCase(const char* inputName, const vector<int>& keys)
+{
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    avlTreeType<int, nodePoolAllocator<int> > inserted;
+    for (size_t i = 0; i < keys.size(); i++)
+        inserted.insert(keys[i]);
+    double insertTime = secondsSince(start);
+
+    start = chrono::steady_clock::now();
+    avlTreeType<int, nodePoolAllocator<int> > built(keys.begin(), keys.end());
+    double buildTime = secondsSince(start);
+
+    cout << left << setw(8) << inputName << right << fixed << setprecision(4)
+         << setw(14) << insertTime << setw(8) << inserted.treeHeight()
+         << setw(14) << buildTime << setw(8) << built.treeHeight() << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t n = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 1000000;
+
+    vector<int> keys(n);
+    for (size_t i = 0; i < n; i++)
+        keys[i] = static_cast<int>(i);
+
+    cout << "keys: " << n << endl;
+    cout << left << setw(8) << "input" << right
+         << setw(14) << "insert (s)" << setw(8) << "height"
+         << setw(14) << "build (s)" << setw(8) << "height" << endl;
+    runCase("sorted", keys);
+    shuffle(keys.begin(), keys.end(), mt19937(12345));
+    runCase("random", keys);
+
+    return 0;
+}
@@ -0,0 +1,120 @@
+// Compares the memory and search time of compactSearchTreeType with
+// bSearchTreeType<int> holding the same keys, inserted in the same
+// random order so the trees have the same shape, and after buildTree.
+// Memory is what the tree asked operator new for, divided by the
+// number of keys; the heap adds its own header to every allocation on
+// top of that, so the nodes of bSearchTreeType take more than reported.
+//
+// Usage: compactBenchmark [number of keys] [number of searches]
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include "../bSearchTreeType.h"
+#include "../compactSearchTreeType.h"
+#include "benchmarkTimer.h"
+
+using namespace std;
+
+// Every allocation keeps its size in front of the block so the bytes
+// in use can be counted.
+static size_t bytesInUse = 0;
+
+void* operator new(size_t size)
+{
+    void* p = malloc(size + sizeof(max_align_t));
+    if (p == nullptr)
+        throw bad_alloc();
+    *static_cast<size_t*>(p) = size;
+    bytesInUse += size;
+    return static_cast<char*>(p) + sizeof(max_align_t);
+}
+
+void operator delete(void* p) noexcept
+{
+    if (p == nullptr)
+        return;
+    p = static_cast<char*>(p) - sizeof(max_align_t);
+    bytesInUse -= *static_cast<size_t*>(p);
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    operator delete(p);
+}
+
+template <class treeType>
+void runCase(const char* caseName, treeType& tree, size_t bytes,
+             const vector<int>& keys, const vector<int>& probes)
+{
+    int found = 0;
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (size_t i = 0; i < probes.size(); i++)
+        found += tree.search(probes[i]);
+    double searchTime = secondsSince(start);
+
+    cout << left << setw(34) << caseName << right << fixed << setprecision(1)
+         << setw(12) << static_cast<double>(bytes) / keys.size()
+         << setw(14) << searchTime * 1e9 / probes.size()
+         << (found == static_cast<int>(probes.size() / 2) ? "" : "  (result mismatch)") << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t n = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 1000000;
+    size_t searches = (argc > 2) ? strtoul(argv[2], nullptr, 10) : 1000000;
+    mt19937 generator(12345);
+
+    // The tree holds even keys; half the probes are odd and miss.
+    vector<int> keys(n);
+    for (size_t i = 0; i < n; i++)
+        keys[i] = static_cast<int>(2 * i);
+    shuffle(keys.begin(), keys.end(), generator);
+
+    vector<int> probes(searches);
+    for (size_t i = 0; i < searches; i++)
+        probes[i] = static_cast<int>(2 * (generator() % n) + i % 2);
+
+    cout << "keys: " << n << ", searches: " << searches << endl;
+    cout << left << setw(34) << "case" << right << setw(12) << "bytes/key"
+         << setw(14) << "search (ns)" << endl;
+
+    size_t before = bytesInUse;
+    {
+        bSearchTreeType<int> tree;
+        for (size_t i = 0; i < n; i++)
+            tree.insert(keys[i]);
+        runCase("bSearchTreeType, random inserts", tree, bytesInUse - before, keys, probes);
+    }
+    {
+        bSearchTreeType<int, nodePoolAllocator<int> > tree;
+        for (size_t i = 0; i < n; i++)
+            tree.insert(keys[i]);
+        runCase("  with nodePoolAllocator", tree, bytesInUse - before, keys, probes);
+    }
+    {
+        compactSearchTreeType<int> tree;
+        for (size_t i = 0; i < n; i++)
+            tree.insert(keys[i]);
+        runCase("compactSearchTreeType, inserts", tree, tree.memoryBytes(), keys, probes);
+        tree.shrinkToFit();
+        runCase("  after shrinkToFit", tree, tree.memoryBytes(), keys, probes);
+    }
+    {
+        bSearchTreeType<int> tree(keys.begin(), keys.end());
+        runCase("bSearchTreeType, buildTree", tree, bytesInUse - before, keys, probes);
+    }
+    {
+        compactSearchTreeType<int> tree(keys.begin(), keys.end());
+        runCase("compactSearchTreeType, buildTree", tree, tree.memoryBytes(), keys, probes);
+    }
+
+    return 0;
+}
@@ -0,0 +1,115 @@
+// Read throughput of concurrentBSearchTreeType against a
+// bSearchTreeType behind one global mutex, with 1, 2, 4, ... reader
+// threads searching while one writer thread inserts and deletes.
+//
+// Usage: concurrentBenchmark [number of keys] [max reader threads]
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <cstdlib>
+#include "../bSearchTreeType.h"
+#include "../concurrentBSearchTreeType.h"
+
+using namespace std;
+
+// bSearchTreeType with every call under one mutex
+class lockedTree
+{
+public:
+    bool search(int item)
+    {
+        lock_guard<mutex> lock(treeLock);
+        return tree.search(item);
+    }
+    void insert(int item)
+    {
+        lock_guard<mutex> lock(treeLock);
+        tree.insert(item);
+    }
+    void deleteNode(int item)
+    {
+        lock_guard<mutex> lock(treeLock);
+        tree.deleteNode(item);
+    }
+
+private:
+    mutex treeLock;
+    bSearchTreeType<int> tree;
+};
+
+// The tree holds the even keys; the writer inserts and deletes odd
+// keys until the readers are done.
+template <class treeType>
+double readsPerSec(treeType& tree, int n, int readers)
+{
+    const chrono::milliseconds duration(500);
+    atomic<bool> stop(false);
+    atomic<long long> reads(0);
+    vector<thread> threads;
+
+    thread writer([&]() {
+        mt19937 gen(99);
+        while (!stop.load(memory_order_relaxed))
+        {
+            int k = 2 * static_cast<int>(gen() % n) + 1;
+            tree.insert(k);
+            tree.deleteNode(k);
+        }
+    });
+    for (int r = 0; r < readers; r++)
+        threads.push_back(thread([&, r]() {
+            mt19937 gen(r);
+            long long done = 0;
+            while (!stop.load(memory_order_relaxed))
+            {
+                tree.search(2 * static_cast<int>(gen() % n));
+                done++;
+            }
+            reads.fetch_add(done);
+        }));
+
+    this_thread::sleep_for(duration);
+    stop.store(true);
+    for (size_t i = 0; i < threads.size(); i++)
+        threads[i].join();
+    writer.join();
+
+    return reads.load() / (duration.count() / 1000.0);
+}
+
+int main(int argc, char* argv[])
+{
+    int n = (argc > 1) ? atoi(argv[1]) : 1000000;
+    int maxReaders = (argc > 2) ? atoi(argv[2]) : 8;
+
+    vector<int> keys(n);
+    for (int i = 0; i < n; i++)
+        keys[i] = 2 * i;
+    shuffle(keys.begin(), keys.end(), mt19937(12345));
+
+    lockedTree locked;
+    concurrentBSearchTreeType<int> concurrent;
+    for (int i = 0; i < n; i++)
+    {
+        locked.insert(keys[i]);
+        concurrent.insert(keys[i]);
+    }
+
+    cout << "keys: " << n << ", hardware threads: "
+         << thread::hardware_concurrency() << endl;
+    cout << setw(8) << "readers" << setw(16) << "mutex reads/s"
+         << setw(20) << "concurrent reads/s" << endl;
+    for (int readers = 1; readers <= maxReaders; readers *= 2)
+        cout << setw(8) << readers << fixed << setprecision(0)
+             << setw(16) << readsPerSec(locked, n, readers)
+             << setw(20) << readsPerSec(concurrent, n, readers) << endl;
+
+    return 0;
+}
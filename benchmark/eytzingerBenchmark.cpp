@@ -0,0 +1,75 @@
+// Compares search on the pointer tree with search on its Eytzinger
+// snapshot. The pointer tree is built with buildTree, so it is
+// perfectly balanced; half of the lookups are misses.
+//
+// Usage: eytzingerBenchmark [number of keys ...]
+//        (default: 1000000 10000000)
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include "../bSearchTreeType.h"
+#include "../eytzingerTreeType.h"
+#include "benchmarkTimer.h"
+
+using namespace std;
+
+template <class treeType>
+double searchesPerSec(const treeType& tree, const vector<int>& queries, size_t& found)
+{
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    found = 0;
+    for (size_t i = 0; i < queries.size(); i++)
+        found += tree.search(queries[i]);
+    return queries.size() / secondsSince(start);
+}
+
+void runCase(size_t n)
+{
+    vector<int> keys(n);
+    for (size_t i = 0; i < n; i++)
+        keys[i] = static_cast<int>(2 * i);
+
+    bSearchTreeType<int> tree(keys.begin(), keys.end());
+    eytzingerTreeType<int> snapshot(tree);
+    keys.clear();
+    keys.shrink_to_fit();
+
+    mt19937 gen(12345);
+    uniform_int_distribution<int> dist(0, static_cast<int>(2 * n - 1));
+    vector<int> queries(2000000);
+    for (size_t i = 0; i < queries.size(); i++)
+        queries[i] = dist(gen);
+
+    size_t treeFound, snapshotFound;
+    double treeRate = searchesPerSec(tree, queries, treeFound);
+    double snapshotRate = searchesPerSec(snapshot, queries, snapshotFound);
+
+    cout << setw(12) << n << fixed << setprecision(0)
+         << setw(16) << treeRate << setw(16) << snapshotRate
+         << setprecision(2) << setw(10) << snapshotRate / treeRate << "x"
+         << (treeFound == snapshotFound ? "" : "  (result mismatch)") << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    vector<size_t> sizes;
+    for (int i = 1; i < argc; i++)
+        sizes.push_back(strtoul(argv[i], nullptr, 10));
+    if (sizes.empty())
+    {
+        sizes.push_back(1000000);
+        sizes.push_back(10000000);
+    }
+
+    cout << setw(12) << "keys" << setw(16) << "tree/sec"
+         << setw(16) << "eytzinger/sec" << setw(11) << "speedup" << endl;
+    for (size_t i = 0; i < sizes.size(); i++)
+        runCase(sizes[i]);
+
+    return 0;
+}
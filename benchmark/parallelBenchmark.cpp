@@ -0,0 +1,71 @@
+// Time the tree-wide operations of a large AVL tree (height, leaves,
+// a sum with parallelReduce, copy and destroy) with 1, 2, 4, ...
+// threads up to the number of hardware threads.
+//
+// Usage: parallelBenchmark [number of keys] [cutoff]
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include "../avlTreeType.h"
+#include "benchmarkTimer.h"
+
+using namespace std;
+
+int main(int argc, char* argv[])
+{
+    size_t n = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 10000000;
+    int cutoff = (argc > 2) ? atoi(argv[2]) : treeParallelismSettings().cutoff;
+    unsigned maxThreads = thread::hardware_concurrency();
+
+    vector<int> keys(n);
+    for (size_t i = 0; i < n; i++)
+        keys[i] = static_cast<int>(i);
+    shuffle(keys.begin(), keys.end(), mt19937(12345));
+
+    avlTreeType<int> tree;
+    for (size_t i = 0; i < n; i++)
+        tree.insert(keys[i]);
+
+    cout << "keys: " << n << ", cutoff: " << cutoff << endl;
+    cout << setw(8) << "threads" << setw(12) << "height (s)" << setw(12) << "leaves (s)"
+         << setw(12) << "sum (s)" << setw(12) << "copy (s)" << setw(14) << "destroy (s)" << endl;
+    for (unsigned threads = 1; threads <= (maxThreads > 0 ? maxThreads : 1); threads *= 2)
+    {
+        setTreeParallelism(threads, cutoff);
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        int height = tree.treeHeight();
+        double heightTime = secondsSince(start);
+
+        start = chrono::steady_clock::now();
+        int leaves = tree.treeLeavesCount();
+        double leavesTime = secondsSince(start);
+
+        start = chrono::steady_clock::now();
+        long long sum = tree.parallelReduce(0LL, [](int x) { return (long long)x; },
+                                            [](long long x, long long y) { return x + y; });
+        double sumTime = secondsSince(start);
+
+        start = chrono::steady_clock::now();
+        avlTreeType<int> copy(tree);
+        double copyTime = secondsSince(start);
+
+        start = chrono::steady_clock::now();
+        copy.destroyTree();
+        double destroyTime = secondsSince(start);
+
+        if (height <= 0 || leaves <= 0 || sum < 0)
+            cout << "unexpected result" << endl;
+        cout << fixed << setprecision(4) << setw(8) << threads << setw(12) << heightTime
+             << setw(12) << leavesTime << setw(12) << sumTime << setw(12) << copyTime
+             << setw(14) << destroyTime << endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,88 @@
+// Compare rebuilding a tree by inserting the keys one by one with
+// loading it from a file written by saveTree, and time searching the
+// same file through mappedSearchTreeType.
+//
+// Usage: serializeBenchmark [number of keys] [file name]
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include "../bSearchTreeType.h"
+#include "../mappedSearchTreeType.h"
+#include "benchmarkTimer.h"
+
+using namespace std;
+
+void report(const char* caseName, double seconds)
+{
+    cout << left << setw(24) << caseName << right << fixed << setprecision(4)
+         << setw(12) << seconds << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t n = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 10000000;
+    const char *fileName = (argc > 2) ? argv[2] : "serializeBenchmark.bst";
+    const size_t lookups = 1000000;
+
+    vector<int> keys(n);
+    for (size_t i = 0; i < n; i++)
+        keys[i] = static_cast<int>(2 * i);
+    shuffle(keys.begin(), keys.end(), mt19937(12345));
+
+    vector<int> probes(lookups);
+    mt19937 generator(54321);
+    for (size_t i = 0; i < lookups; i++)
+        probes[i] = static_cast<int>(generator() % (2 * n + 1));
+
+    cout << "keys: " << n << endl;
+    cout << left << setw(24) << "case" << right << setw(12) << "time (s)" << endl;
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    bSearchTreeType<int> inserted;
+    for (size_t i = 0; i < n; i++)
+        inserted.insert(keys[i]);
+    report("insert one by one", secondsSince(start));
+
+    start = chrono::steady_clock::now();
+    if (!inserted.saveTree(fileName))
+    {
+        cout << "Cannot write " << fileName << endl;
+        return 1;
+    }
+    report("saveTree", secondsSince(start));
+
+    start = chrono::steady_clock::now();
+    bSearchTreeType<int> loaded;
+    if (!loaded.loadTree(fileName))
+        cout << "loadTree failed" << endl;
+    report("loadTree", secondsSince(start));
+
+    start = chrono::steady_clock::now();
+    mappedSearchTreeType<int> mapped(fileName);
+    report("mapped open", secondsSince(start));
+
+    size_t found = 0;
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < lookups; i++)
+        found += mapped.search(probes[i]);
+    report("mapped 1M searches", secondsSince(start));
+
+    size_t loadedFound = 0;
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < lookups; i++)
+        loadedFound += loaded.search(probes[i]);
+    report("loaded 1M searches", secondsSince(start));
+
+    if (found != loadedFound)
+        cout << "mismatch: " << found << " vs " << loadedFound << endl;
+
+    mapped.close();
+    remove(fileName);
+    return 0;
+}
@@ -0,0 +1,109 @@
+// Compares unionWith, intersectWith and differenceWith with the loops
+// they replace: inserting or deleting every item of one tree in the
+// other, or deleting the items the other tree does not have. The
+// first tree holds random keys; the second holds 1K, 100K or 1M
+// random keys, half of them shared with the first.
+//
+// Usage: setOpsBenchmark [number of keys in the first tree]
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include "../avlTreeType.h"
+#include "benchmarkTimer.h"
+
+using namespace std;
+
+void report(const char* treeName, const char* operation, size_t m,
+            double loopTime, double setTime, bool same)
+{
+    cout << left << setw(6) << treeName << setw(14) << operation << right << setw(9) << m
+         << fixed << setprecision(4) << setw(12) << loopTime << setw(12) << setTime
+         << setprecision(2) << setw(9) << loopTime / setTime << "x"
+         << (same ? "" : "  (result mismatch)") << endl;
+}
+
+template <class treeType>
+void runCase(const char* treeName, const vector<int>& keys, const vector<int>& otherKeys)
+{
+    const treeType first(keys.begin(), keys.end());
+    const treeType second(otherKeys.begin(), otherKeys.end());
+    size_t m = otherKeys.size();
+
+    {
+        treeType looped(first), merged(first), other(second);
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        second.inorderTraversal([&looped](const int& item) { looped.insert(item); });
+        double loopTime = secondsSince(start);
+
+        start = chrono::steady_clock::now();
+        merged.unionWith(other);
+        report(treeName, "union", m, loopTime, secondsSince(start),
+               looped.treeNodeCount() == merged.treeNodeCount());
+    }
+    {
+        treeType looped(first), merged(first);
+        vector<int> missing;
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        first.inorderTraversal([&missing, &second](const int& item)
+        {
+            if (!second.search(item))
+                missing.push_back(item);
+        });
+        for (size_t i = 0; i < missing.size(); i++)
+            looped.deleteNode(missing[i]);
+        double loopTime = secondsSince(start);
+
+        start = chrono::steady_clock::now();
+        merged.intersectWith(second);
+        report(treeName, "intersection", m, loopTime, secondsSince(start),
+               looped.treeNodeCount() == merged.treeNodeCount());
+    }
+    {
+        treeType looped(first), merged(first);
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        second.inorderTraversal([&looped](const int& item) { looped.deleteNode(item); });
+        double loopTime = secondsSince(start);
+
+        start = chrono::steady_clock::now();
+        merged.differenceWith(second);
+        report(treeName, "difference", m, loopTime, secondsSince(start),
+               looped.treeNodeCount() == merged.treeNodeCount());
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    size_t n = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 1000000;
+    const size_t otherSizes[] = {1000, 100000, 1000000};
+    mt19937 generator(12345);
+
+    // The first tree holds even keys; half of the keys of the second
+    // tree are even, the others odd.
+    vector<int> keys(n);
+    for (size_t i = 0; i < n; i++)
+        keys[i] = static_cast<int>(2 * i);
+    shuffle(keys.begin(), keys.end(), generator);
+
+    cout << "keys in the first tree: " << n << endl;
+    cout << left << setw(6) << "tree" << setw(14) << "operation" << right << setw(9) << "m"
+         << setw(12) << "loop (s)" << setw(12) << "set op (s)" << setw(10) << "speedup" << endl;
+    for (size_t s = 0; s < sizeof(otherSizes) / sizeof(otherSizes[0]); s++)
+    {
+        vector<int> otherKeys(otherSizes[s]);
+        for (size_t i = 0; i < otherKeys.size(); i++)
+            otherKeys[i] = static_cast<int>(2 * (generator() % n) + i % 2);
+
+        runCase<bSearchTreeType<int> >("bst", keys, otherKeys);
+        runCase<avlTreeType<int> >("avl", keys, otherKeys);
+    }
+
+    return 0;
+}
@@ -0,0 +1,85 @@
+// Compares taking a consistent view of a tree by a deep copy of
+// avlTreeType with persistentTreeType::snapshot, and the cost of the
+// inserts that follow while the views are kept.
+//
+// Usage: snapshotBenchmark [number of keys] [inserts between snapshots]
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include "../avlTreeType.h"
+#include "../persistentTreeType.h"
+#include "benchmarkTimer.h"
+
+using namespace std;
+
+void report(const char* caseName, double seconds)
+{
+    cout << left << setw(36) << caseName << right << fixed << setprecision(6)
+         << setw(14) << seconds << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t n = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 1000000;
+    size_t interval = (argc > 2) ? strtoul(argv[2], nullptr, 10) : 1000;
+    const size_t updates = 100000;
+    const int views = 10;
+
+    vector<int> keys(n);
+    for (size_t i = 0; i < n; i++)
+        keys[i] = static_cast<int>(2 * i);
+    shuffle(keys.begin(), keys.end(), mt19937(12345));
+
+    vector<int> newKeys(updates);
+    mt19937 generator(54321);
+    for (size_t i = 0; i < updates; i++)
+        newKeys[i] = static_cast<int>(2 * (generator() % n) + 1);
+
+    avlTreeType<int> tree(keys.begin(), keys.end());
+    persistentTreeType<int> persistent;
+    for (size_t i = 0; i < n; i++)
+        persistent.insert(keys[i]);
+
+    cout << "keys: " << n << ", a view every " << interval << " inserts" << endl;
+    cout << left << setw(36) << "case" << right << setw(14) << "time (s)" << endl;
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int i = 0; i < views; i++)
+    {
+        avlTreeType<int> view(tree);
+    }
+    report("deep copy (avlTreeType), each", secondsSince(start) / views);
+
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < views; i++)
+    {
+        persistentTreeType<int> view = persistent.snapshot();
+    }
+    report("snapshot (persistentTreeType), each", secondsSince(start) / views);
+
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < updates; i++)
+        tree.insert(newKeys[i]);
+    report("100K inserts, avlTreeType", secondsSince(start));
+
+    // The last snapshot is kept while the next interval of inserts runs,
+    // so the inserts have to copy the nodes they share with it.
+    persistentTreeType<int> view;
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < updates; i++)
+    {
+        if (i % interval == 0)
+            view = persistent.snapshot();
+        persistent.insert(newKeys[i]);
+    }
+    report("100K inserts, with snapshots", secondsSince(start));
+
+    if (tree.treeNodeCount() != persistent.treeNodeCount())
+        cout << "mismatch: " << tree.treeNodeCount() << " vs " << persistent.treeNodeCount() << endl;
+    return 0;
+}
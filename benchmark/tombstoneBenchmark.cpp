@@ -0,0 +1,117 @@
+// Times every deleteNode of delete-heavy bursts, one at a time, and
+// reports the latency percentiles: bSearchTreeType and avlTreeType
+// unlink and restructure at once, lazyDeleteTreeType marks tombstones
+// and compacts a bounded piece whenever they pass the threshold, or,
+// with that compaction off, calls compactStep between the bursts. Each
+// burst deletes a tenth of the keys at random and the inserts that
+// follow put them back.
+//
+// Usage: tombstoneBenchmark [number of keys] [number of bursts]
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include "../avlTreeType.h"
+#include "../lazyDeleteTreeType.h"
+
+using namespace std;
+
+template <class treeType>
+void runCase(const char* treeName, treeType& tree, const vector<int>& keys,
+             size_t bursts, int idleSteps)
+{
+    mt19937 generator(54321);
+    vector<int> live(keys), removed;
+    vector<double> latencies;
+    size_t burstSize = keys.size() / 10;
+    bool same = true;
+
+    for (size_t i = 0; i < keys.size(); i++)
+        tree.insert(keys[i]);
+
+    for (size_t b = 0; b < bursts; b++)
+    {
+        shuffle(live.begin(), live.end(), generator);
+        for (size_t i = 0; i < burstSize; i++)
+        {
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            same = tree.deleteNode(live.back()) && same;
+            chrono::duration<double, nano> elapsed = chrono::steady_clock::now() - start;
+            latencies.push_back(elapsed.count());
+            removed.push_back(live.back());
+            live.pop_back();
+        }
+
+        // Idle time between bursts, then the deleted keys return.
+        for (int i = 0; i < idleSteps; i++)
+        {
+            tree.compactStep(64);
+        }
+        for (size_t i = 0; i < burstSize; i++)
+        {
+            same = tree.insert(removed.back()) && same;
+            live.push_back(removed.back());
+            removed.pop_back();
+        }
+    }
+
+    sort(latencies.begin(), latencies.end());
+    size_t count = latencies.size();
+    cout << left << setw(20) << treeName << right << fixed << setprecision(0)
+         << setw(10) << latencies[count / 2] << setw(10) << latencies[count * 99 / 100]
+         << setw(10) << latencies[count * 999 / 1000] << setw(12) << latencies[count - 1]
+         << (same && tree.treeNodeCount() == static_cast<int>(live.size()) ? "" : "  (result mismatch)")
+         << endl;
+}
+
+// The restructuring trees have nothing to do between bursts.
+template <class elemType>
+struct immediateTree : avlTreeType<elemType>
+{
+    void compactStep(int) {}
+};
+
+template <class elemType>
+struct immediateBSearchTree : bSearchTreeType<elemType>
+{
+    void compactStep(int) {}
+};
+
+int main(int argc, char* argv[])
+{
+    size_t n = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 1000000;
+    size_t bursts = (argc > 2) ? strtoul(argv[2], nullptr, 10) : 10;
+    mt19937 generator(12345);
+
+    vector<int> keys(n);
+    for (size_t i = 0; i < n; i++)
+        keys[i] = static_cast<int>(i);
+    shuffle(keys.begin(), keys.end(), generator);
+
+    cout << "keys: " << n << ", bursts: " << bursts << " of " << n / 10 << " deletes" << endl;
+    cout << left << setw(20) << "tree" << right << setw(10) << "p50 (ns)" << setw(10) << "p99"
+         << setw(10) << "p99.9" << setw(12) << "max" << endl;
+    {
+        immediateBSearchTree<int> tree;
+        runCase("bst", tree, keys, bursts, 0);
+    }
+    {
+        immediateTree<int> tree;
+        runCase("avl", tree, keys, bursts, 0);
+    }
+    {
+        lazyDeleteTreeType<int> tree;
+        runCase("lazy", tree, keys, bursts, 0);
+    }
+    {
+        lazyDeleteTreeType<int> tree;
+        tree.setCompaction(1, 64);
+        runCase("lazy, idle compact", tree, keys, bursts, static_cast<int>(n / 64));
+    }
+
+    return 0;
+}
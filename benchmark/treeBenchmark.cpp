@@ -0,0 +1,391 @@
+// Benchmark suite of the tree operations, built on Google Benchmark.
+// Every operation is run for
+//      element types       int, int64 (long long), string
+//      trees               bSearchTreeType (bst), avlTreeType (avl)
+//      key orders          random, sorted, reverse, zipf
+//      sizes               1K, 10K, ... up to --max_size (default 1M,
+//                          at most 100M)
+// and named <operation><type>/<tree>/<order>/<size>, e.g.
+// insert<int>/avl/random/1000000. The unbalanced tree is not run on
+// sorted or reverse keys above 10K, where every operation is linear.
+// The zipf order draws the keys with a Zipf(0.99) skew, so it holds
+// duplicates and its searches hit a few hot keys most of the time.
+// Half of the searches are for keys that are not in the tree.
+//
+// Usage: treeBenchmark [--max_size=N] [Google Benchmark flags], e.g.
+//      treeBenchmark --benchmark_filter='search<int>/avl'
+//      treeBenchmark --benchmark_out=results.json --benchmark_out_format=json
+// The JSON files of two versions can be compared with the compare.py
+// tool of Google Benchmark.
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <typeinfo>
+#include <vector>
+#include "../avlTreeType.h"
+
+using namespace std;
+
+const size_t degenerateLimit = 10000;       // Largest sorted input for bst
+
+enum keyOrder { randomOrder, sortedOrder, reverseOrder, zipfOrder };
+const char* const orderNames[] = {"random", "sorted", "reverse", "zipf"};
+
+// Keys: the key of value v is increasing in v. The tree holds the keys
+// of even values; the keys of odd values are misses.
+template <class elemType>
+elemType makeKey(size_t v);
+
+template <>
+int makeKey<int>(size_t v)
+{
+    return static_cast<int>(v);
+}
+
+template <>
+long long makeKey<long long>(size_t v)
+{
+    return (1LL << 40) + static_cast<long long>(v);
+}
+
+template <>
+string makeKey<string>(size_t v)
+{
+    char text[16];
+
+    snprintf(text, sizeof(text), "k%012zu", v);
+    return string(text);
+}
+
+size_t keyWeight(int x) { return static_cast<size_t>(x); }
+size_t keyWeight(long long x) { return static_cast<size_t>(x); }
+size_t keyWeight(const string& x) { return x.size() + static_cast<unsigned char>(x.back()); }
+
+// Zipf distributed ranks in [0, n), the generator of Gray et al.
+// ("Quickly generating billion-record synthetic databases").
+class zipfGenerator
+{
+public:
+    zipfGenerator(size_t n, double theta)
+    {
+        double zeta2 = 1.0 + pow(0.5, theta);
+
+        count = n;
+        this->theta = theta;
+        zetan = 0;
+        for (size_t i = 1; i <= n; i++)
+            zetan += 1.0 / pow(static_cast<double>(i), theta);
+        alpha = 1.0 / (1.0 - theta);
+        eta = (1.0 - pow(2.0 / n, 1.0 - theta)) / (1.0 - zeta2 / zetan);
+    }
+
+    size_t next(mt19937_64& generator)
+    {
+        double u = uniform_real_distribution<double>(0.0, 1.0)(generator);
+        double uz = u * zetan;
+
+        if (uz < 1.0)
+            return 0;
+        if (uz < 1.0 + pow(0.5, theta))
+            return 1;
+        size_t rank = static_cast<size_t>(count * pow(eta * u - eta + 1.0, alpha));
+        return (rank < count ? rank : count - 1);
+    }
+
+private:
+    size_t count;
+    double theta, zetan, alpha, eta;
+};
+
+template <class elemType>
+struct keySet
+{
+    vector<elemType> keys;          // Keys in insertion order
+    vector<elemType> probes;        // Search keys, every other one a miss
+};
+
+// Only the keys and the tree of the benchmark being run are kept, so
+// a run up to 100M keys does not hold the data of every earlier set;
+// the benchmarks of one set are registered next to each other.
+struct cachedData
+{
+    virtual ~cachedData() {}
+};
+
+template <class dataType>
+struct cachedValue: cachedData
+{
+    dataType value;
+};
+
+unique_ptr<cachedData> keyCache, treeCache;
+string keyCacheName, treeCacheName;
+
+template <class elemType>
+const keySet<elemType>& getKeys(keyOrder order, size_t n)
+{
+    string name = string(typeid(elemType).name()) + "/" + orderNames[order] + "/" + to_string(n);
+
+    if (keyCacheName == name)
+        return static_cast<cachedValue<keySet<elemType> >*>(keyCache.get())->value;
+
+    keyCache.reset();
+    keyCacheName.clear();
+
+    cachedValue<keySet<elemType> > *cached = new cachedValue<keySet<elemType> >;
+    keySet<elemType>& keys = cached->value;
+    vector<size_t> ranks(n);
+    mt19937_64 generator(12345);
+
+    keyCache.reset(cached);
+    for (size_t i = 0; i < n; i++)
+        ranks[i] = i;
+    if (order == randomOrder)
+        shuffle(ranks.begin(), ranks.end(), generator);
+    else if (order == reverseOrder)
+        reverse(ranks.begin(), ranks.end());
+    else if (order == zipfOrder)
+    {
+        // The hot ranks are spread over the key range.
+        vector<size_t> spread(ranks);
+        zipfGenerator zipf(n, 0.99);
+
+        shuffle(spread.begin(), spread.end(), generator);
+        for (size_t i = 0; i < n; i++)
+            ranks[i] = spread[zipf.next(generator)];
+    }
+
+    keys.keys.reserve(n);
+    keys.probes.reserve(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        keys.keys.push_back(makeKey<elemType>(2 * ranks[i]));
+        keys.probes.push_back(makeKey<elemType>(2 * ranks[i] + (i % 2)));
+    }
+    keyCacheName = name;
+    return keys;
+}
+
+template <class treeType, class elemType>
+const treeType& getTree(keyOrder order, size_t n)
+// The tree built by inserting the keys, shared by the benchmarks that
+// do not change it.
+{
+    string name = string(typeid(treeType).name()) + "/" + orderNames[order] + "/" + to_string(n);
+
+    if (treeCacheName == name)
+        return static_cast<cachedValue<treeType>*>(treeCache.get())->value;
+
+    treeCache.reset();
+    treeCacheName.clear();
+
+    const keySet<elemType>& keys = getKeys<elemType>(order, n);
+    cachedValue<treeType> *cached = new cachedValue<treeType>;
+
+    treeCache.reset(cached);
+    for (size_t i = 0; i < keys.keys.size(); i++)
+        cached->value.insert(keys.keys[i]);
+    treeCacheName = name;
+    return cached->value;
+}
+
+template <class treeType, class elemType>
+void insertBenchmark(benchmark::State& state, keyOrder order, size_t n)
+{
+    const keySet<elemType>& keys = getKeys<elemType>(order, n);
+
+    for (auto _ : state)
+    {
+        treeType tree;
+        for (size_t i = 0; i < n; i++)
+            tree.insert(keys.keys[i]);
+
+        state.PauseTiming();
+        tree.destroyTree();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+template <class treeType, class elemType>
+void searchBenchmark(benchmark::State& state, keyOrder order, size_t n)
+{
+    const keySet<elemType>& keys = getKeys<elemType>(order, n);
+    const treeType& tree = getTree<treeType, elemType>(order, n);
+
+    for (auto _ : state)
+    {
+        size_t found = 0;
+        for (size_t i = 0; i < n; i++)
+            found += tree.search(keys.probes[i]);
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+template <class treeType, class elemType>
+void deleteBenchmark(benchmark::State& state, keyOrder order, size_t n)
+{
+    const keySet<elemType>& keys = getKeys<elemType>(order, n);
+    const treeType& built = getTree<treeType, elemType>(order, n);
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        treeType tree(built);
+        state.ResumeTiming();
+
+        for (size_t i = 0; i < n; i++)
+            tree.deleteNode(keys.keys[i]);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+template <class treeType, class elemType>
+void copyBenchmark(benchmark::State& state, keyOrder order, size_t n)
+{
+    const treeType& built = getTree<treeType, elemType>(order, n);
+
+    for (auto _ : state)
+    {
+        treeType tree(built);
+
+        state.PauseTiming();
+        tree.destroyTree();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * built.treeNodeCount());
+}
+
+template <class treeType, class elemType>
+void destroyBenchmark(benchmark::State& state, keyOrder order, size_t n)
+{
+    const treeType& built = getTree<treeType, elemType>(order, n);
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        treeType tree(built);
+        state.ResumeTiming();
+
+        tree.destroyTree();
+    }
+    state.SetItemsProcessed(state.iterations() * built.treeNodeCount());
+}
+
+template <class treeType, class elemType>
+void buildBenchmark(benchmark::State& state, keyOrder order, size_t n)
+{
+    const keySet<elemType>& keys = getKeys<elemType>(order, n);
+
+    for (auto _ : state)
+    {
+        treeType tree(keys.keys.begin(), keys.keys.end());
+
+        state.PauseTiming();
+        tree.destroyTree();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+template <class treeType, class elemType>
+void traversalBenchmark(benchmark::State& state, keyOrder order, size_t n, int traversal)
+{
+    const treeType& tree = getTree<treeType, elemType>(order, n);
+    size_t sum = 0;
+    auto visit = [&sum](const elemType& item) { sum += keyWeight(item); };
+
+    for (auto _ : state)
+    {
+        if (traversal == 0)
+            tree.inorderTraversal(visit);
+        else if (traversal == 1)
+            tree.preorderTraversal(visit);
+        else if (traversal == 2)
+            tree.postorderTraversal(visit);
+        else
+            tree.levelorderTraversal(visit);
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * tree.treeNodeCount());
+}
+
+template <class treeType, class elemType>
+void registerTree(const string& typeName, const string& treeName, keyOrder order, size_t n)
+{
+    const char* const traversalNames[] = {"inorder", "preorder", "postorder", "levelorder"};
+    string suffix = "<" + typeName + ">/" + treeName + "/" + orderNames[order] + "/" + to_string(n);
+
+    benchmark::RegisterBenchmark(("insert" + suffix).c_str(),
+        [=](benchmark::State& state) { insertBenchmark<treeType, elemType>(state, order, n); })
+        ->Unit(benchmark::kMicrosecond);
+    benchmark::RegisterBenchmark(("search" + suffix).c_str(),
+        [=](benchmark::State& state) { searchBenchmark<treeType, elemType>(state, order, n); })
+        ->Unit(benchmark::kMicrosecond);
+    benchmark::RegisterBenchmark(("deleteNode" + suffix).c_str(),
+        [=](benchmark::State& state) { deleteBenchmark<treeType, elemType>(state, order, n); })
+        ->Unit(benchmark::kMicrosecond);
+    benchmark::RegisterBenchmark(("copyTree" + suffix).c_str(),
+        [=](benchmark::State& state) { copyBenchmark<treeType, elemType>(state, order, n); })
+        ->Unit(benchmark::kMicrosecond);
+    benchmark::RegisterBenchmark(("destroyTree" + suffix).c_str(),
+        [=](benchmark::State& state) { destroyBenchmark<treeType, elemType>(state, order, n); })
+        ->Unit(benchmark::kMicrosecond);
+    benchmark::RegisterBenchmark(("buildTree" + suffix).c_str(),
+        [=](benchmark::State& state) { buildBenchmark<treeType, elemType>(state, order, n); })
+        ->Unit(benchmark::kMicrosecond);
+    for (int traversal = 0; traversal < 4; traversal++)
+        benchmark::RegisterBenchmark((traversalNames[traversal] + suffix).c_str(),
+            [=](benchmark::State& state) { traversalBenchmark<treeType, elemType>(state, order, n, traversal); })
+            ->Unit(benchmark::kMicrosecond);
+}
+
+template <class elemType>
+void registerType(const string& typeName, size_t maxSize)
+{
+    for (size_t n = 1000; n <= maxSize && n <= 100000000; n *= 10)
+        for (int order = randomOrder; order <= zipfOrder; order++)
+        {
+            keyOrder keys = static_cast<keyOrder>(order);
+
+            if (n <= degenerateLimit || keys == randomOrder || keys == zipfOrder)
+                registerTree<bSearchTreeType<elemType>, elemType>(typeName, "bst", keys, n);
+            registerTree<avlTreeType<elemType>, elemType>(typeName, "avl", keys, n);
+        }
+}
+
+int main(int argc, char* argv[])
+{
+    size_t maxSize = 1000000;
+    int kept = 1;
+
+    // Take --max_size out of the arguments before Google Benchmark
+    // sees them.
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--max_size=", 11) == 0)
+            maxSize = strtoull(argv[i] + 11, nullptr, 10);
+        else
+            argv[kept++] = argv[i];
+    }
+    argc = kept;
+
+    registerType<int>("int", maxSize);
+    registerType<long long>("int64", maxSize);
+    registerType<string>("string", maxSize);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
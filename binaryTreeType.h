@@ -4,6 +4,15 @@
 #define BINARYTREETYPE_H
 
 #include <iostream>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "nodeAllocator.h"
+#include "treeDiagnostics.h"
+#include "treeParallelism.h"
+#include "treeStatistics.h"
 
 using namespace std;
 
@@ -14,14 +23,201 @@ struct nodeType
     elemType info;                  // Store the data
     nodeType<elemType> *lLink;      // Pointer to the left child
     nodeType<elemType> *rLink;      // Pointer to the right child
+    int height;                     // Height of the subtree rooted at this
+                                    // node (kept up to date by avlTreeType)
+    int size;                       // Number of nodes in the subtree rooted
+                                    // at this node
 };
 
+// Definition of the inorder iterator
+// The iterator keeps the path from the root to the current node, so
+// both ++ and -- take amortized constant time and no parent links are
+// needed in the nodes. The end iterator has an empty path; decrementing
+// it moves to the largest node.
+template <class elemType, bool isConst>
+class inorderIterator
+{
+public:
+    typedef bidirectional_iterator_tag iterator_category;
+    typedef elemType value_type;
+    typedef ptrdiff_t difference_type;
+    typedef typename conditional<isConst, const elemType*, elemType*>::type pointer;
+    typedef typename conditional<isConst, const elemType&, elemType&>::type reference;
+
+    reference operator*() const;
+    pointer operator->() const;
+
+    inorderIterator<elemType, isConst>& operator++();
+    inorderIterator<elemType, isConst> operator++(int);
+    inorderIterator<elemType, isConst>& operator--();
+    inorderIterator<elemType, isConst> operator--(int);
+
+    bool operator==(const inorderIterator<elemType, isConst>& other) const;
+    bool operator!=(const inorderIterator<elemType, isConst>& other) const;
+
+    operator inorderIterator<elemType, true>() const;
+    //Conversion from iterator to const_iterator.
+
+    inorderIterator(nodeType<elemType> *treeRoot = nullptr, bool atBegin = false);
+    //Constructor
+    //Postcondition: The iterator points to the smallest node of
+    // the tree to which treeRoot points if atBegin is
+    // true; otherwise, it is the end iterator.
+
+    inorderIterator(nodeType<elemType> *treeRoot, const vector<nodeType<elemType>*>& nodePath);
+    //Constructor
+    //Postcondition: The iterator points to the last node of
+    // nodePath, which is the path from treeRoot.
+
+private:
+    void pushLeftmost(nodeType<elemType> *p);
+    void pushRightmost(nodeType<elemType> *p);
+
+    nodeType<elemType> *root;                   // Root of the tree being walked
+    vector<nodeType<elemType>*> path;           // Nodes from root to the current node
+};
+
+template <class elemType, bool isConst>
+inorderIterator<elemType, isConst>::inorderIterator(nodeType<elemType> *treeRoot, bool atBegin)
+{
+    root = treeRoot;
+    if (atBegin)
+        pushLeftmost(root);
+}
+
+template <class elemType, bool isConst>
+inorderIterator<elemType, isConst>::inorderIterator(nodeType<elemType> *treeRoot,
+                const vector<nodeType<elemType>*>& nodePath)
+    : root(treeRoot), path(nodePath)
+{
+}
+
+template <class elemType, bool isConst>
+void inorderIterator<elemType, isConst>::pushLeftmost(nodeType<elemType> *p)
+{
+    while (p != nullptr)
+    {
+        path.push_back(p);
+        p = p->lLink;
+    }
+}
+
+template <class elemType, bool isConst>
+void inorderIterator<elemType, isConst>::pushRightmost(nodeType<elemType> *p)
+{
+    while (p != nullptr)
+    {
+        path.push_back(p);
+        p = p->rLink;
+    }
+}
+
+template <class elemType, bool isConst>
+typename inorderIterator<elemType, isConst>::reference
+inorderIterator<elemType, isConst>::operator*() const
+{
+    return path.back()->info;
+}
+
+template <class elemType, bool isConst>
+typename inorderIterator<elemType, isConst>::pointer
+inorderIterator<elemType, isConst>::operator->() const
+{
+    return &path.back()->info;
+}
+
+template <class elemType, bool isConst>
+inorderIterator<elemType, isConst>& inorderIterator<elemType, isConst>::operator++()
+// If the current node has a right subtree, the successor is the
+// smallest node in it; otherwise it is the nearest ancestor whose
+// left subtree holds the current node.
+{
+    nodeType<elemType> *child;
+
+    if (path.back()->rLink != nullptr)
+        pushLeftmost(path.back()->rLink);
+    else
+    {
+        do
+        {
+            child = path.back();
+            path.pop_back();
+        } while (!path.empty() && path.back()->rLink == child);
+    }
+    return *this;
+}
+
+template <class elemType, bool isConst>
+inorderIterator<elemType, isConst> inorderIterator<elemType, isConst>::operator++(int)
+{
+    inorderIterator<elemType, isConst> temp(*this);
+
+    ++*this;
+    return temp;
+}
+
+template <class elemType, bool isConst>
+inorderIterator<elemType, isConst>& inorderIterator<elemType, isConst>::operator--()
+// Mirror image of operator++; the end iterator moves to the
+// largest node of the tree.
+{
+    nodeType<elemType> *child;
+
+    if (path.empty())
+        pushRightmost(root);
+    else if (path.back()->lLink != nullptr)
+        pushRightmost(path.back()->lLink);
+    else
+    {
+        do
+        {
+            child = path.back();
+            path.pop_back();
+        } while (!path.empty() && path.back()->lLink == child);
+    }
+    return *this;
+}
+
+template <class elemType, bool isConst>
+inorderIterator<elemType, isConst> inorderIterator<elemType, isConst>::operator--(int)
+{
+    inorderIterator<elemType, isConst> temp(*this);
+
+    --*this;
+    return temp;
+}
+
+template <class elemType, bool isConst>
+bool inorderIterator<elemType, isConst>::operator==(const inorderIterator<elemType, isConst>& other) const
+{
+    if (path.empty() || other.path.empty())
+        return path.empty() && other.path.empty();
+    else
+        return path.back() == other.path.back();
+}
+
+template <class elemType, bool isConst>
+bool inorderIterator<elemType, isConst>::operator!=(const inorderIterator<elemType, isConst>& other) const
+{
+    return !(*this == other);
+}
+
+template <class elemType, bool isConst>
+inorderIterator<elemType, isConst>::operator inorderIterator<elemType, true>() const
+{
+    return inorderIterator<elemType, true>(root, path);
+}
+
 // Definition of the class
-template <class elemType>
+// allocType supplies the nodes of the tree (see nodeAllocator.h).
+template <class elemType, class allocType = nodeAllocator<elemType> >
 class binaryTreeType
 {
 public:
-    const binaryTreeType<elemType>& operator= (const binaryTreeType<elemType>&);
+    typedef inorderIterator<elemType, false> iterator;
+    typedef inorderIterator<elemType, true> const_iterator;
+
+    const binaryTreeType<elemType, allocType>& operator= (const binaryTreeType<elemType, allocType>&);
     // Overload the assignment operator.
 
     bool isEmpty() const;
@@ -49,24 +245,122 @@ public:
     // Function to do a postorder traversal of the binary tree.
     // Postcondition: Nodes are printed in postorder sequence.
 
+    template <class visitor>
+    void inorderTraversal(visitor&& visit);
+    template <class visitor>
+    void preorderTraversal(visitor&& visit);
+    template <class visitor>
+    void postorderTraversal(visitor&& visit);
+    template <class visitor>
+    void levelorderTraversal(visitor&& visit);
+    //Functions to traverse the binary tree with any callable
+    //object (function, lambda or function object) taking an
+    //elemType&. The call is resolved at compile time, so the
+    //compiler can inline the visitor, and a lambda can keep
+    //its own state (sums, counts, filters) without globals.
+    //The level order traversal visits the nodes level by
+    //level, from left to right.
+    //Postcondition: visit is applied to each node of the
+    // binary tree in the order of the traversal.
+
+    template <class visitor>
+    void inorderTraversal(visitor&& visit) const;
+    template <class visitor>
+    void preorderTraversal(visitor&& visit) const;
+    template <class visitor>
+    void postorderTraversal(visitor&& visit) const;
+    template <class visitor>
+    void levelorderTraversal(visitor&& visit) const;
+    //Same as above for a const binary tree; visit is called
+    //with a const elemType&.
+
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
+    // Functions to walk the binary tree in inorder sequence with
+    // iterators, e.g. in a range-based for loop or with the
+    // standard algorithms. Changing an item through an iterator
+    // of a binary search tree must not change its order.
+    // Postcondition:   begin() points to the first node in
+    //                  inorder sequence; end() points past the
+    //                  last node.
+
+    template <class resultType, class mapFn, class combineFn>
+    resultType parallelReduce(resultType identity, mapFn map, combineFn combine) const;
+    //Function to combine map(item) over all the items of the
+    //binary tree on up to treeThreadCount() threads (see
+    //treeParallelism.h). combine must be associative and
+    //identity must be its identity element.
+    //The results are combined in inorder sequence over a split
+    //of the tree that depends only on its shape and the cutoff,
+    //so the result is the same for any number of threads, even
+    //for a floating point sum.
+    //Postcondition: Returns the combination of map(item) over
+    // the items, identity if the tree is empty.
+
+    template <class visitor>
+    void parallelVisit(visitor&& visit);
+    template <class visitor>
+    void parallelVisit(visitor&& visit) const;
+    //Functions to apply visit to every node of the binary tree
+    //on up to treeThreadCount() threads. Each task visits its
+    //nodes in inorder sequence, but the tasks run at the same
+    //time, so visit must be safe to call concurrently.
+    //Postcondition: visit is applied to each node once.
+
     int treeHeight() const;
     // Function to determine the height of a binary tree.
     // Postcondition: Returns the height of the binary tree.
+    //                Trees with more nodes than the cutoff of
+    //                treeParallelism.h are walked in parallel,
+    //                as are treeLeavesCount, the copy and
+    //                destroyTree (the last two only when the
+    //                allocator is threadSafe).
 
     int treeNodeCount() const;
     // Function to determine the number of nodes in a binary tree.
     // Postcondition: Returns the number of nodes in the binary tree.
+    //                Takes constant time: it is the size stored in
+    //                the root node.
 
     int treeLeavesCount() const;
     // Function to determine the number of leaves in a 
     // binary tree.
     // Postcondition: Returns the number of leaves in the binary tree.
 
+    treeShape shapeReport() const;
+    // Function to describe the shape of the binary tree, e.g. to
+    // tell when a binary search tree has degenerated.
+    // Postcondition: Returns treeNodeCount(), treeHeight(), the
+    //                smallest height possible for that many nodes,
+    //                treeLeavesCount() and the number of nodes
+    //                with each balance factor (height of the left
+    //                subtree minus height of the right subtree).
+
+#ifdef BINARYTREE_STATS
+    const treeStatistics& statistics() const;
+    // Postcondition: Returns the statistics recorded by search,
+    //                insert and deleteNode (see treeStatistics.h).
+
+    void resetStatistics();
+    // Postcondition: The recorded statistics are zero.
+
+    void writeStatistics(ostream& out) const;
+    // Function to export the statistics as JSON.
+    // Postcondition: Writes an object with the statistics of each
+    //                operation, the node counts of the allocator
+    //                and the shapeReport.
+#endif
+
     void destroyTree();
     // Function to destroy the binary tree.
     // Postcondition:   Memory space occupied by each node
     //                  is deallocated.
     //                  root = nullptr;
+    //                  If the allocator can release all of its
+    //                  nodes at once and elemType needs no
+    //                  destructor, no node is visited.
 
     virtual bool search(const elemType& searchItem) const = 0;
     // Function to determine if searchItem is in the binary
@@ -75,23 +369,42 @@ public:
     //                  the binary tree; otherwise, returns
     //                  false.
 
-    virtual void insert(const elemType& insertItem) = 0;
+    virtual bool insert(const elemType& insertItem) = 0;
+    virtual bool insert(elemType&& insertItem) = 0;
     // Function to insert insertItem in the binary tree.
     // Postcondition:   If there is no node in the binary tree
     //                  that has the same info as insertItem, a
     //                  node with the info insertItem is created
-    //                  and inserted in the binary search tree.
+    //                  and inserted in the binary search tree,
+    //                  and true is returned; otherwise, the
+    //                  insertDuplicate event is reported and
+    //                  false is returned.
+    //                  The second version moves insertItem into
+    //                  the node instead of copying it.
 
-    virtual void deleteNode(const elemType& deleteItem) = 0;
+    virtual bool deleteNode(const elemType& deleteItem) = 0;
     // Function to delete deleteItem from the binary tree
     // Postcondition:   If a node with the same info as deleteItem is found, it is deleted
-    //                  from the binary tree.
-    //                  if the binary tree is empty of deleteItem is not in the binary tree,
-    //                  an appropriate message is printed.
+    //                  from the binary tree and true is returned.
+    //                  If the binary tree is empty or deleteItem is not in the binary tree,
+    //                  the matching event (see treeDiagnostics.h) is reported and false
+    //                  is returned.
 
-    binaryTreeType(const binaryTreeType<elemType>& otherTree);
+    binaryTreeType(const binaryTreeType<elemType, allocType>& otherTree);
     // Copy constructor
 
+    binaryTreeType(binaryTreeType<elemType, allocType>&& otherTree);
+    // Move constructor
+    // Postcondition:   The nodes (and the allocator that owns them)
+    //                  are taken over from otherTree in constant
+    //                  time; otherTree is empty.
+
+    binaryTreeType<elemType, allocType>& operator= (binaryTreeType<elemType, allocType>&& otherTree);
+    // Move assignment operator
+    // Postcondition:   The nodes of this tree are destroyed and the
+    //                  nodes of otherTree are taken over; otherTree
+    //                  is empty.
+
     binaryTreeType();
     // Default constructor
 
@@ -100,14 +413,59 @@ public:
 
 protected:
     nodeType<elemType> *root;           // Pointer to the root node of the binary tree
+    allocType alloc;                    // Allocator of the nodes of the binary tree
+#ifdef BINARYTREE_STATS
+    mutable treeStatistics stats;       // Recorded by the search tree operations
+#endif
+
+    int nodeCount(nodeType<elemType> *p) const;
+    // Function to determine the number of nodes in
+    // the binary tree to which p points.
+    // Postcondition: The number of nodes in the binary
+    //                tree to which p points is returned.
 
 private:
+    struct treeTask
+    {
+        nodeType<elemType> *node;       // Root of the subtree, or a single node
+        int depth;                      // Depth of node, the root has depth 1
+        bool wholeSubtree;              // Whether the task covers node's subtree
+    };
+
+    void splitTree(nodeType<elemType> *p, vector<treeTask>& tasks) const;
+    // Function to cut the binary tree to which p points into
+    // tasks for the parallel operations.
+    // Postcondition: tasks holds, in inorder sequence, the
+    //                subtrees of at most cutoff nodes that hang
+    //                below the nodes with more than cutoff nodes,
+    //                and those nodes on their own.
+
+    template <class resultType, class evaluateFn, class combineFn>
+    resultType reduceTasks(resultType identity, evaluateFn evaluate, combineFn combine) const;
+    // Function to evaluate every task of the binary tree in
+    // parallel.
+    // Postcondition: Returns the results of evaluate(task)
+    //                combined in inorder sequence.
+
+    bool worthParallel(nodeType<elemType> *p) const;
+    // Postcondition: Returns true if the binary tree to which
+    //                p points is larger than the cutoff and more
+    //                than one thread may be used.
+
     void copyTree(nodeType<elemType>* &copiedTreeRoot, nodeType<elemType>* otherTreeRoot);
     // Makes a copy of the binary tree to which
     // otherTreeRoot points.
     // Postcondition: The pointer copiedTreeRoot points to
     //                the root of the copied binary tree.
 
+    void copySubtree(nodeType<elemType>* &copiedTreeRoot, nodeType<elemType>* otherTreeRoot);
+    // Serial part of copyTree.
+
+    void parallelDestroy(nodeType<elemType>* &p);
+    // Function to destroy the binary tree to which p points,
+    // one task per subtree of at most cutoff nodes.
+    // Postcondition: Same as destroy.
+
     void destroy(nodeType<elemType>* &p);
     // Function to destroy the binary tree to which p points.
     // Postcondition: Memory space occupied by each node, in
@@ -115,6 +473,20 @@ private:
     //                deallocated.
     //                p = nullptr;
 
+    template <class visitor>
+    static void inorderVisit(nodeType<elemType> *p, visitor& visit);
+    template <class visitor>
+    static void preorderVisit(nodeType<elemType> *p, visitor& visit);
+    template <class visitor>
+    static void postorderVisit(nodeType<elemType> *p, visitor& visit);
+    template <class visitor>
+    static void levelorderVisit(nodeType<elemType> *p, visitor& visit);
+    //Functions to traverse the binary tree to which p points
+    //with an explicit stack (a queue for the level order).
+    //Every traversal of the class is done by one of these.
+    //Postcondition: visit is applied to each node of the
+    // binary tree to which p points.
+
     void inorder(nodeType<elemType> *p) const;
     // Function to do an inorder traversal of the binary
     // tree to which p points.
@@ -152,12 +524,6 @@ private:
     // Function to determine the larger of x and y.
     // Postcondition: Returns the larger of x and y.
 
-    int nodeCount(nodeType<elemType> *p) const;
-    // Function to determine the number of nodes in
-    // the binary tree to which p points.
-    // Postcondition: The number of nodes in the binary
-    //                tree to which p points is returned.
-
     int leavesCount(nodeType<elemType> *p) const;
     // Function to determine the number of leaves in
     // the binary tree to which p points.
@@ -165,15 +531,15 @@ private:
     //                tree to which p points is returned.
 };
 
-template <class elemType>
-bool binaryTreeType<elemType>::isEmpty() const
+template <class elemType, class allocType>
+bool binaryTreeType<elemType, allocType>::isEmpty() const
 {
     return (root == nullptr);
 }
 
 // Constructor
-template <class elemType>
-binaryTreeType<elemType>::binaryTreeType()
+template <class elemType, class allocType>
+binaryTreeType<elemType, allocType>::binaryTreeType()
 {
     root = nullptr;
 }
@@ -187,8 +553,8 @@ binaryTreeType<elemType>::binaryTreeType()
 // Postorder traversal: Delete all of the nodes of a binary tree
 // Inorder traversal: Visits the nodes in sorted order in binary 
 // search trees.
-template <class elemType>
-void binaryTreeType<elemType>::inorderTraversal() const
+template <class elemType, class allocType>
+void binaryTreeType<elemType, allocType>::inorderTraversal() const
 // The binary tree is traversed as follows:
 // 1. Traverse the left subtree.
 // 2. Visit the node
@@ -197,8 +563,8 @@ void binaryTreeType<elemType>::inorderTraversal() const
     inorder(root);
 }
 
-template <class elemType>
-void binaryTreeType<elemType>::preorderTraversal() const
+template <class elemType, class allocType>
+void binaryTreeType<elemType, allocType>::preorderTraversal() const
 // The binary tree is traversed as follows:
 // 1. Visit the node.
 // 2. Traverse the left subtree.
@@ -207,8 +573,8 @@ void binaryTreeType<elemType>::preorderTraversal() const
     preorder(root);
 }
 
-template <class elemType>
-void binaryTreeType<elemType>::postorderTraversal() const
+template <class elemType, class allocType>
+void binaryTreeType<elemType, allocType>::postorderTraversal() const
 // The binary tree is traversed as follows:
 // 1. Traverse the left subtree.
 // 2. Traverse the right subtree.
@@ -217,85 +583,437 @@ void binaryTreeType<elemType>::postorderTraversal() const
     postorder(root);
 }
 
-template <class elemType>
-int binaryTreeType<elemType>::treeHeight() const
+template <class elemType, class allocType>
+typename binaryTreeType<elemType, allocType>::iterator binaryTreeType<elemType, allocType>::begin()
 {
-    return height(root);
+    return iterator(root, true);
 }
 
-template <class elemType>
-int binaryTreeType<elemType>::treeNodeCount() const
+template <class elemType, class allocType>
+typename binaryTreeType<elemType, allocType>::iterator binaryTreeType<elemType, allocType>::end()
+{
+    return iterator(root, false);
+}
+
+template <class elemType, class allocType>
+typename binaryTreeType<elemType, allocType>::const_iterator binaryTreeType<elemType, allocType>::begin() const
+{
+    return const_iterator(root, true);
+}
+
+template <class elemType, class allocType>
+typename binaryTreeType<elemType, allocType>::const_iterator binaryTreeType<elemType, allocType>::end() const
+{
+    return const_iterator(root, false);
+}
+
+template <class elemType, class allocType>
+int binaryTreeType<elemType, allocType>::treeHeight() const
+{
+    if (!worthParallel(root))
+        return height(root);
+
+    auto taskHeight = [this](const treeTask& task)
+    {
+        if (task.wholeSubtree)
+            return task.depth - 1 + height(task.node);
+        else
+            return task.depth;
+    };
+    auto larger = [this](int x, int y) { return max(x, y); };
+
+    return reduceTasks(0, taskHeight, larger);
+}
+
+template <class elemType, class allocType>
+int binaryTreeType<elemType, allocType>::treeNodeCount() const
 {
     return nodeCount(root);
 }
 
-template <class elemType>
-int binaryTreeType<elemType>::treeLeavesCount() const
+template <class elemType, class allocType>
+int binaryTreeType<elemType, allocType>::nodeCount(nodeType<elemType> *p) const
+{
+    if (p == nullptr)
+        return 0;
+    else
+        return p->size;
+}
+
+template <class elemType, class allocType>
+int binaryTreeType<elemType, allocType>::treeLeavesCount() const
 {
-    return leavesCount(root);
+    if (!worthParallel(root))
+        return leavesCount(root);
+
+    // A node on its own has more than cutoff nodes below it, so it
+    // is never a leaf.
+    auto taskLeaves = [this](const treeTask& task)
+    {
+        return (task.wholeSubtree ? leavesCount(task.node) : 0);
+    };
+    auto sum = [](int x, int y) { return x + y; };
+
+    return reduceTasks(0, taskLeaves, sum);
 }
 
-template <class elemType>
-void binaryTreeType<elemType>::inorder(nodeType<elemType> *p) const
+template <class elemType, class allocType>
+treeShape binaryTreeType<elemType, allocType>::shapeReport() const
+// The heights are computed bottom up in postorder: the stack holds the
+// nodes still to be finished (second is true once their subtrees have
+// been pushed), and heights holds the heights of the finished subtrees
+// whose parent is not finished yet.
+{
+    treeShape shape;
+    vector<pair<nodeType<elemType>*, bool> > stack;
+    vector<int> heights;
+
+    stack.push_back(make_pair(root, false));
+    while (!stack.empty())
+    {
+        nodeType<elemType> *p = stack.back().first;
+        bool subtreesDone = stack.back().second;
+        stack.pop_back();
+
+        if (p == nullptr)
+            heights.push_back(0);
+        else if (!subtreesDone)
+        {
+            stack.push_back(make_pair(p, true));
+            stack.push_back(make_pair(p->rLink, false));
+            stack.push_back(make_pair(p->lLink, false));
+        }
+        else
+        {
+            int rHeight = heights.back();
+            heights.pop_back();
+            int lHeight = heights.back();
+            heights.pop_back();
+
+            shape.balanceFactors[lHeight - rHeight]++;
+            if (lHeight == 0 && rHeight == 0)
+                shape.leaves++;
+            heights.push_back(1 + max(lHeight, rHeight));
+        }
+    }
+
+    shape.height = heights.back();
+    shape.nodeCount = nodeCount(root);
+    while ((1LL << shape.optimalHeight) - 1 < shape.nodeCount)
+        shape.optimalHeight++;
+    return shape;
+}
+
+#ifdef BINARYTREE_STATS
+template <class elemType, class allocType>
+const treeStatistics& binaryTreeType<elemType, allocType>::statistics() const
+{
+    return stats;
+}
+
+template <class elemType, class allocType>
+void binaryTreeType<elemType, allocType>::resetStatistics()
+{
+    stats.reset();
+}
+
+template <class elemType, class allocType>
+void binaryTreeType<elemType, allocType>::writeStatistics(ostream& out) const
+{
+    out << "{\"operations\": ";
+    stats.writeJson(out);
+    out << ", \"allocations\": " << alloc.counter.allocationCount()
+        << ", \"deallocations\": " << alloc.counter.deallocationCount()
+        << ", \"shape\": ";
+    shapeReport().writeJson(out);
+    out << "}";
+}
+#endif
+
+template <class elemType, class allocType>
+bool binaryTreeType<elemType, allocType>::worthParallel(nodeType<elemType> *p) const
+{
+    return (nodeCount(p) > treeParallelismSettings().cutoff && treeThreadCount() > 1);
+}
+
+template <class elemType, class allocType>
+void binaryTreeType<elemType, allocType>::splitTree(nodeType<elemType> *p, vector<treeTask>& tasks) const
+// An inorder walk that does not go below the nodes of at most cutoff
+// nodes; only the top of the tree is visited.
+{
+    int cutoff = treeParallelismSettings().cutoff;
+    vector<pair<nodeType<elemType>*, int> > stack;
+    int depth = 1;
+
+    while (true)
+    {
+        while (p != nullptr && p->size > cutoff)
+        {
+            stack.push_back(make_pair(p, depth));
+            p = p->lLink;
+            depth++;
+        }
+        if (p != nullptr)
+        {
+            treeTask task = {p, depth, true};
+            tasks.push_back(task);
+        }
+        if (stack.empty())
+            break;
+        p = stack.back().first;
+        depth = stack.back().second;
+        stack.pop_back();
+
+        treeTask task = {p, depth, false};
+        tasks.push_back(task);
+        p = p->rLink;
+        depth++;
+    }
+}
+
+template <class elemType, class allocType>
+template <class resultType, class evaluateFn, class combineFn>
+resultType binaryTreeType<elemType, allocType>::reduceTasks(resultType identity, evaluateFn evaluate,
+                combineFn combine) const
+{
+    struct resultSlot               // keeps vector<bool> from packing
+    {                               // the results of different threads
+        resultType value;           // into one word
+    };
+    vector<treeTask> tasks;
+    vector<resultSlot> results;
+    resultType total = identity;
+
+    splitTree(root, tasks);
+    results.resize(tasks.size(), resultSlot{identity});
+
+    auto runTask = [&](size_t i) { results[i].value = evaluate(tasks[i]); };
+    parallelFor(tasks.size(), treeThreadCount(), runTask);
+
+    for (size_t i = 0; i < results.size(); i++)
+        total = combine(total, results[i].value);
+    return total;
+}
+
+template <class elemType, class allocType>
+template <class resultType, class mapFn, class combineFn>
+resultType binaryTreeType<elemType, allocType>::parallelReduce(resultType identity, mapFn map,
+                combineFn combine) const
+{
+    auto taskResult = [&](const treeTask& task)
+    {
+        if (!task.wholeSubtree)
+            return resultType(map(static_cast<const elemType&>(task.node->info)));
+
+        resultType result = identity;
+        auto fold = [&](elemType& item) { result = combine(result, map(static_cast<const elemType&>(item))); };
+        inorderVisit(task.node, fold);
+        return result;
+    };
+
+    return reduceTasks(identity, taskResult, combine);
+}
+
+template <class elemType, class allocType>
+template <class visitor>
+void binaryTreeType<elemType, allocType>::parallelVisit(visitor&& visit)
+{
+    vector<treeTask> tasks;
+
+    splitTree(root, tasks);
+
+    auto runTask = [&](size_t i)
+    {
+        if (tasks[i].wholeSubtree)
+            inorderVisit(tasks[i].node, visit);
+        else
+            visit(tasks[i].node->info);
+    };
+    parallelFor(tasks.size(), treeThreadCount(), runTask);
+}
+
+template <class elemType, class allocType>
+template <class visitor>
+void binaryTreeType<elemType, allocType>::parallelVisit(visitor&& visit) const
+{
+    vector<treeTask> tasks;
+    auto constVisit = [&visit](elemType& item) { visit(static_cast<const elemType&>(item)); };
+
+    splitTree(root, tasks);
+
+    auto runTask = [&](size_t i)
+    {
+        if (tasks[i].wholeSubtree)
+            inorderVisit(tasks[i].node, constVisit);
+        else
+            constVisit(tasks[i].node->info);
+    };
+    parallelFor(tasks.size(), treeThreadCount(), runTask);
+}
+
+template <class elemType, class allocType>
+void binaryTreeType<elemType, allocType>::inorder(nodeType<elemType> *p) const
 // The binary tree is traversed as follows:
 // 1. Traverse the left subtree.
 // 2. Visit the node
 // 3. Traverse the right subtree.
 {
-    if (p != nullptr)
+    auto printItem = [](elemType& item) { cout << item << " "; };
+
+    inorderVisit(p, printItem);
+}
+
+template <class elemType, class allocType>
+template <class visitor>
+void binaryTreeType<elemType, allocType>::inorderVisit(nodeType<elemType> *p, visitor& visit)
+// The recursion is replaced by an explicit stack of the nodes whose
+// left subtree is being traversed, so the depth of the tree is not
+// limited by the size of the call stack.
+{
+    vector<nodeType<elemType>*> stack;
+
+    while (p != nullptr || !stack.empty())
     {
-        inorder(p->lLink);
-        cout << p->info << " ";
-        inorder(p->rLink);
+        while (p != nullptr)
+        {
+            stack.push_back(p);
+            p = p->lLink;
+        }
+        p = stack.back();
+        stack.pop_back();
+        visit(p->info);
+        p = p->rLink;
     }
 }
 
-template <class elemType>
-void binaryTreeType<elemType>::preorder(nodeType<elemType> *p) const
+template <class elemType, class allocType>
+void binaryTreeType<elemType, allocType>::preorder(nodeType<elemType> *p) const
 // The binary tree is traversed as follows:
 // 1. Visit the node.
 // 2. Traverse the left subtree.  
 // 3. Traverse the right subtree.
 {
-    if (p != nullptr)
-    {   
-        cout << p->info << " ";
-        preorder(p->lLink);
-        preorder(p->rLink);
+    auto printItem = [](elemType& item) { cout << item << " "; };
+
+    preorderVisit(p, printItem);
+}
+
+template <class elemType, class allocType>
+template <class visitor>
+void binaryTreeType<elemType, allocType>::preorderVisit(nodeType<elemType> *p, visitor& visit)
+// The stack holds the right subtrees still to be traversed.
+{
+    vector<nodeType<elemType>*> stack;
+
+    while (p != nullptr || !stack.empty())
+    {
+        if (p == nullptr)
+        {
+            p = stack.back();
+            stack.pop_back();
+        }
+        visit(p->info);
+        if (p->rLink != nullptr)
+            stack.push_back(p->rLink);
+        p = p->lLink;
     }
 }
 
-template <class elemType>
-void binaryTreeType<elemType>::postorder(nodeType<elemType> *p) const
+template <class elemType, class allocType>
+void binaryTreeType<elemType, allocType>::postorder(nodeType<elemType> *p) const
 // The binary tree is traversed as follows:
 // 1. Traverse the left subtree.
 // 2. Traverse the right subtree.
 // 3. Visit the node
 {
-    if (p != nullptr)
+    auto printItem = [](elemType& item) { cout << item << " "; };
+
+    postorderVisit(p, printItem);
+}
+
+template <class elemType, class allocType>
+template <class visitor>
+void binaryTreeType<elemType, allocType>::postorderVisit(nodeType<elemType> *p, visitor& visit)
+// The stack holds the nodes whose subtrees are being traversed; a
+// node is visited once its right subtree is done, which is the case
+// when the right subtree is empty or was the last one visited.
+{
+    vector<nodeType<elemType>*> stack;
+    nodeType<elemType> *lastVisited = nullptr;
+
+    while (p != nullptr || !stack.empty())
     {
-        postorder(p->lLink);
-        postorder(p->rLink);
-        cout << p->info << " ";
+        while (p != nullptr)
+        {
+            stack.push_back(p);
+            p = p->lLink;
+        }
+        p = stack.back();
+        if (p->rLink != nullptr && p->rLink != lastVisited)
+            p = p->rLink;
+        else
+        {
+            visit(p->info);
+            lastVisited = p;
+            stack.pop_back();
+            p = nullptr;
+        }
     }
 }
 
-template <class elemType>
-int binaryTreeType<elemType>::height(nodeType<elemType> *p) const
+template <class elemType, class allocType>
+int binaryTreeType<elemType, allocType>::height(nodeType<elemType> *p) const
 // Height(p) denotes the height of the binary tree with root p
 // If the binary tree is empty, then the height is 0
 // If tree is non-binary, first find the height of the left subtree and 
 // the height of the right subtree. Then take the maximum of these two 
 // heights and add 1 to find the height of the binary tree.
+// Equivalently, the height is the largest depth of a node, which is
+// found with an explicit stack of (node, depth) pairs.
 {
-    if (p == nullptr)
-        return 0;
-    else
-        return 1 + max(height(p->lLink), height(p->rLink));
+    vector<pair<nodeType<elemType>*, int> > stack;
+    int maxDepth = 0;
+
+    if (p != nullptr)
+        stack.push_back(make_pair(p, 1));
+    while (!stack.empty())
+    {
+        p = stack.back().first;
+        int depth = stack.back().second;
+        stack.pop_back();
+        maxDepth = max(maxDepth, depth);
+        if (p->lLink != nullptr)
+            stack.push_back(make_pair(p->lLink, depth + 1));
+        if (p->rLink != nullptr)
+            stack.push_back(make_pair(p->rLink, depth + 1));
+    }
+    return maxDepth;
 }
 
-template <class elemType>
-int binaryTreeType<elemType>::max(int x, int y) const
+template <class elemType, class allocType>
+int binaryTreeType<elemType, allocType>::leavesCount(nodeType<elemType> *p) const
+{
+    vector<nodeType<elemType>*> stack;
+    int count = 0;
+
+    if (p != nullptr)
+        stack.push_back(p);
+    while (!stack.empty())
+    {
+        p = stack.back();
+        stack.pop_back();
+        if (p->lLink == nullptr && p->rLink == nullptr)
+            count++;
+        if (p->lLink != nullptr)
+            stack.push_back(p->lLink);
+        if (p->rLink != nullptr)
+            stack.push_back(p->rLink);
+    }
+    return count;
+}
+
+template <class elemType, class allocType>
+int binaryTreeType<elemType, allocType>::max(int x, int y) const
 // Determine the larger of two intergers.
 {
     if (x >= y)
@@ -304,46 +1022,166 @@ int binaryTreeType<elemType>::max(int x, int y) const
         return y;
 }
 
-template <class elemType>
-void binaryTreeType<elemType>::copyTree(nodeType<elemType>* &copiedTreeRoot, nodeType<elemType>* otherTreeRoot)
+template <class elemType, class allocType>
+void binaryTreeType<elemType, allocType>::copyTree(nodeType<elemType>* &copiedTreeRoot, nodeType<elemType>* otherTreeRoot)
+// In parallel, the nodes with more than cutoff nodes are copied
+// first; the links of their copies to the subtrees of at most cutoff
+// nodes are left for the tasks to fill in.
+{
+    if (!allocType::threadSafe || !worthParallel(otherTreeRoot))
+    {
+        copySubtree(copiedTreeRoot, otherTreeRoot);
+        return;
+    }
+
+    int cutoff = treeParallelismSettings().cutoff;
+    vector<pair<nodeType<elemType>*, nodeType<elemType>**> > stack;
+    vector<pair<nodeType<elemType>*, nodeType<elemType>**> > tasks;
+    nodeType<elemType> *newNode;
+
+    stack.push_back(make_pair(otherTreeRoot, &copiedTreeRoot));
+    while (!stack.empty())
+    {
+        otherTreeRoot = stack.back().first;
+        nodeType<elemType>* &link = *stack.back().second;
+        stack.pop_back();
+        if (nodeCount(otherTreeRoot) <= cutoff)
+            tasks.push_back(make_pair(otherTreeRoot, &link));
+        else
+        {
+            newNode = alloc.allocate(otherTreeRoot->info);
+            newNode->height = otherTreeRoot->height;
+            newNode->size = otherTreeRoot->size;
+            link = newNode;
+            stack.push_back(make_pair(otherTreeRoot->rLink, &newNode->rLink));
+            stack.push_back(make_pair(otherTreeRoot->lLink, &newNode->lLink));
+        }
+    }
+
+    auto copyTask = [this, &tasks](size_t i) { copySubtree(*tasks[i].second, tasks[i].first); };
+    parallelFor(tasks.size(), treeThreadCount(), copyTask);
+} //end copyTree
+
+template <class elemType, class allocType>
+void binaryTreeType<elemType, allocType>::copySubtree(nodeType<elemType>* &copiedTreeRoot, nodeType<elemType>* otherTreeRoot)
 // To make an identical copy of a binary tree
 // If we use just the value of the pointer of the root node to make 
 // a copy of a binary tree, we get a shallow copy of the data.
 // -> We need to create as many nodes as there are in the binary
 // tree to be copied.
+// The nodes are copied in preorder; the stack holds pairs of a node
+// still to be copied and the link of the copy that must point to it.
 {
-    if (otherTreeRoot == nullptr)
-        copiedTreeRoot = nullptr;
-    else
+    vector<pair<nodeType<elemType>*, nodeType<elemType>**> > stack;
+    nodeType<elemType> *newNode;
+
+    if (allocType::bulkRelease)
+        alloc.reserve(nodeCount(otherTreeRoot));
+    stack.push_back(make_pair(otherTreeRoot, &copiedTreeRoot));
+    while (!stack.empty())
     {
-        copiedTreeRoot = new nodeType<elemType>;
-        copiedTreeRoot->info = otherTreeRoot->info;             // Copy info into the copy tree root
-        copyTree(copiedTreeRoot->lLink, otherTreeRoot->lLink);  // Copy pointer left link
-        copyTree(copiedTreeRoot->rLink, otherTreeRoot->rLink);  // Copy pointer right link
+        otherTreeRoot = stack.back().first;
+        nodeType<elemType>* &link = *stack.back().second;
+        stack.pop_back();
+        if (otherTreeRoot == nullptr)
+            link = nullptr;
+        else
+        {
+            newNode = alloc.allocate(otherTreeRoot->info);      // Copy info into the new node
+            newNode->height = otherTreeRoot->height;
+            newNode->size = otherTreeRoot->size;
+            link = newNode;
+            stack.push_back(make_pair(otherTreeRoot->rLink, &newNode->rLink));  // Copy right link
+            stack.push_back(make_pair(otherTreeRoot->lLink, &newNode->lLink));  // Copy left link
+        }
     }
-} //end copyTree
+} //end copySubtree
 
-template <class elemType>
-void binaryTreeType<elemType>::destroy(nodeType<elemType>* &p)
+template <class elemType, class allocType>
+void binaryTreeType<elemType, allocType>::destroy(nodeType<elemType>* &p)
+// Needs neither recursion nor a stack: while the current node has a
+// left child it is rotated to the right, otherwise it has no left
+// subtree and can be deleted before moving on to its right child.
+{
+    nodeType<elemType> *current = p;
+    nodeType<elemType> *temp;
+
+    while (current != nullptr)
+    {
+        if (current->lLink != nullptr)
+        {
+            temp = current->lLink;
+            current->lLink = temp->rLink;
+            temp->rLink = current;
+            current = temp;
+        }
+        else
+        {
+            temp = current;
+            current = current->rLink;
+            alloc.deallocate(temp);
+        }
+    }
+    p = nullptr;
+}
+
+template <class elemType, class allocType>
+void binaryTreeType<elemType, allocType>::parallelDestroy(nodeType<elemType>* &p)
+// The nodes with more than cutoff nodes are only deallocated after the
+// tasks have destroyed the subtrees below them.
 {
+    int cutoff = treeParallelismSettings().cutoff;
+    vector<nodeType<elemType>*> stack;
+    vector<nodeType<elemType>*> upperNodes;
+    vector<nodeType<elemType>*> tasks;
+
     if (p != nullptr)
+        stack.push_back(p);
+    while (!stack.empty())
     {
-        destroy(p->lLink);
-        destroy(p->rLink);
-        delete p;
-        p = nullptr;
+        nodeType<elemType> *current = stack.back();
+        stack.pop_back();
+        if (current->size <= cutoff)
+            tasks.push_back(current);
+        else
+        {
+            upperNodes.push_back(current);
+            if (current->lLink != nullptr)
+                stack.push_back(current->lLink);
+            if (current->rLink != nullptr)
+                stack.push_back(current->rLink);
+        }
     }
+
+    auto destroyTask = [this, &tasks](size_t i) { destroy(tasks[i]); };
+    parallelFor(tasks.size(), treeThreadCount(), destroyTask);
+
+    for (size_t i = 0; i < upperNodes.size(); i++)
+        alloc.deallocate(upperNodes[i]);
+    p = nullptr;
 }
 
-template <class elemType>
-void binaryTreeType<elemType>::destroyTree()
+template <class elemType, class allocType>
+void binaryTreeType<elemType, allocType>::destroyTree()
 {
-    destroy(root);
+    if (allocType::bulkRelease && is_trivially_destructible<elemType>::value)
+    {
+        alloc.releaseAll();
+        root = nullptr;
+    }
+    else
+    {
+        if (allocType::threadSafe && worthParallel(root))
+            parallelDestroy(root);
+        else
+            destroy(root);
+        alloc.releaseAll();
+    }
 }
 
 //copy constructor
-template <class elemType>
-binaryTreeType<elemType>::binaryTreeType(const binaryTreeType<elemType>& otherTree)
+template <class elemType, class allocType>
+binaryTreeType<elemType, allocType>::binaryTreeType(const binaryTreeType<elemType, allocType>& otherTree)
 {
     if (otherTree.root == nullptr) //otherTree is empty
         root = nullptr;
@@ -351,22 +1189,31 @@ binaryTreeType<elemType>::binaryTreeType(const binaryTreeType<elemType>& otherTr
         copyTree(root, otherTree.root);
 }
 
+//move constructor
+template <class elemType, class allocType>
+binaryTreeType<elemType, allocType>::binaryTreeType(binaryTreeType<elemType, allocType>&& otherTree)
+    : alloc(std::move(otherTree.alloc))
+{
+    root = otherTree.root;
+    otherTree.root = nullptr;
+}
+
 //Destructor
-template <class elemType>
-binaryTreeType<elemType>::~binaryTreeType()
+template <class elemType, class allocType>
+binaryTreeType<elemType, allocType>::~binaryTreeType()
 {
-    destroy(root);
+    destroyTree();
 }
 
 //Overload the assignment operator
-template <class elemType>
-const binaryTreeType<elemType>& binaryTreeType<elemType>::operator=(const binaryTreeType<elemType>& otherTree)
+template <class elemType, class allocType>
+const binaryTreeType<elemType, allocType>& binaryTreeType<elemType, allocType>::operator=(const binaryTreeType<elemType, allocType>& otherTree)
 {
     if (this != &otherTree) //avoid self-copy
     {
         if (root != nullptr) //if the binary tree is not empty,
         //destroy the binary tree
-            destroy(root);
+            destroyTree();
         if (otherTree.root == nullptr) //otherTree is empty
             root = nullptr;
         else
@@ -375,21 +1222,116 @@ const binaryTreeType<elemType>& binaryTreeType<elemType>::operator=(const binary
     return *this;
 }
 
-template <class elemType>
-void binaryTreeType<elemType>::inorderTraversal(void (*visit) (elemType& item)) const
+//Move assignment operator
+template <class elemType, class allocType>
+binaryTreeType<elemType, allocType>& binaryTreeType<elemType, allocType>::operator=(binaryTreeType<elemType, allocType>&& otherTree)
+{
+    if (this != &otherTree)
+    {
+        destroyTree();
+        alloc = std::move(otherTree.alloc);
+        root = otherTree.root;
+        otherTree.root = nullptr;
+    }
+    return *this;
+}
+
+template <class elemType, class allocType>
+void binaryTreeType<elemType, allocType>::inorderTraversal(void (*visit) (elemType& item)) const
 {
     inorder(root, *visit);
 }
 
-template <class elemType>
-void binaryTreeType<elemType>::inorder(nodeType<elemType>* p, void (*visit) (elemType& item)) const
+template <class elemType, class allocType>
+void binaryTreeType<elemType, allocType>::inorder(nodeType<elemType>* p, void (*visit) (elemType& item)) const
+{
+    inorderVisit(p, visit);
+}
+
+template <class elemType, class allocType>
+template <class visitor>
+void binaryTreeType<elemType, allocType>::levelorderVisit(nodeType<elemType> *p, visitor& visit)
+// The binary tree is traversed level by level: the queue holds the
+// nodes of the current level followed by their children.
 {
+    vector<nodeType<elemType>*> queue;
+    size_t front = 0;
+
     if (p != nullptr)
+        queue.push_back(p);
+    while (front < queue.size())
     {
-        inorder(p->lLink, *visit);
-        (*visit)(p->info);
-        inorder(p->rLink, *visit);
+        p = queue[front++];
+        visit(p->info);
+        if (p->lLink != nullptr)
+            queue.push_back(p->lLink);
+        if (p->rLink != nullptr)
+            queue.push_back(p->rLink);
     }
 }
 
+template <class elemType, class allocType>
+template <class visitor>
+void binaryTreeType<elemType, allocType>::inorderTraversal(visitor&& visit)
+{
+    inorderVisit(root, visit);
+}
+
+template <class elemType, class allocType>
+template <class visitor>
+void binaryTreeType<elemType, allocType>::preorderTraversal(visitor&& visit)
+{
+    preorderVisit(root, visit);
+}
+
+template <class elemType, class allocType>
+template <class visitor>
+void binaryTreeType<elemType, allocType>::postorderTraversal(visitor&& visit)
+{
+    postorderVisit(root, visit);
+}
+
+template <class elemType, class allocType>
+template <class visitor>
+void binaryTreeType<elemType, allocType>::levelorderTraversal(visitor&& visit)
+{
+    levelorderVisit(root, visit);
+}
+
+template <class elemType, class allocType>
+template <class visitor>
+void binaryTreeType<elemType, allocType>::inorderTraversal(visitor&& visit) const
+{
+    auto constVisit = [&visit](elemType& item) { visit(static_cast<const elemType&>(item)); };
+
+    inorderVisit(root, constVisit);
+}
+
+template <class elemType, class allocType>
+template <class visitor>
+void binaryTreeType<elemType, allocType>::preorderTraversal(visitor&& visit) const
+{
+    auto constVisit = [&visit](elemType& item) { visit(static_cast<const elemType&>(item)); };
+
+    preorderVisit(root, constVisit);
+}
+
+template <class elemType, class allocType>
+template <class visitor>
+void binaryTreeType<elemType, allocType>::postorderTraversal(visitor&& visit) const
+{
+    auto constVisit = [&visit](elemType& item) { visit(static_cast<const elemType&>(item)); };
+
+    postorderVisit(root, constVisit);
+}
+
+template <class elemType, class allocType>
+template <class visitor>
+void binaryTreeType<elemType, allocType>::levelorderTraversal(visitor&& visit) const
+{
+    auto constVisit = [&visit](elemType& item) { visit(static_cast<const elemType&>(item)); };
+
+    levelorderVisit(root, constVisit);
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,503 @@
+#ifndef COMPACTSEARCHTREETYPE_H
+#define COMPACTSEARCHTREETYPE_H
+
+/* A binary search tree stored compactly for large indexes.
+    1. The nodes live in one vector and link to each other by 32-bit
+    indices instead of 64-bit pointers; index 0 stands for no node.
+    A node of int items takes 12 bytes, against 32 for nodeType<int>
+    plus the overhead of its heap allocation.
+    2. The tree is threaded: the top bit of a link marks a thread. A
+    left thread points to the inorder predecessor and a right thread
+    to the inorder successor (0 if there is none), so inorderTraversal
+    needs no stack and no parent links are stored.
+    3. Deleted nodes are kept on a free list and reused by insert.
+    4. buildTree stores the nodes in inorder sequence, so after it an
+    inorder walk reads the vector front to back.
+   Like bSearchTreeType, the tree is not rebalanced; every operation is
+   iterative, so a degenerate tree costs time but no stack. There is
+   room for 2^31 - 1 nodes, free ones included; past that insert and
+   buildTree throw length_error and leave the tree unchanged.
+*/
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "treeCompare.h"
+#include "treeDiagnostics.h"
+
+using namespace std;
+
+// Definition of the node
+template <class elemType>
+struct compactNodeType
+{
+    elemType info;                  // Store the data
+    uint32_t lLink;                 // Left child, or predecessor if threaded
+    uint32_t rLink;                 // Right child, or successor if threaded
+};
+
+template <class elemType, class compareType = less<elemType> >
+class compactSearchTreeType
+{
+public:
+    bool search(const elemType& searchItem) const;
+    //Function to determine if searchItem is in the tree.
+    //Postcondition: Returns true if searchItem is found;
+    // otherwise, returns false. Searching an empty
+    // tree reports the searchEmptyTree event.
+
+    bool insert(const elemType& insertItem);
+    bool insert(elemType&& insertItem);
+    //Function to insert insertItem in the tree.
+    //Postcondition: If there is no node with the same info as
+    // insertItem, one is added (reusing a deleted
+    // node if there is one) and true is returned;
+    // otherwise, insertDuplicate is reported and
+    // false is returned. Throws length_error if a new
+    // node would not fit in a 31-bit index.
+
+    bool deleteNode(const elemType& deleteItem);
+    //Function to delete deleteItem from the tree.
+    //Postcondition: If a node with the same info as deleteItem
+    // is found, it is deleted and put on the free
+    // list and true is returned; otherwise,
+    // deleteEmptyTree or deleteNotFound is reported
+    // and false is returned.
+
+    template <class visitor>
+    void inorderTraversal(visitor&& visit) const;
+    //Function to visit the items in inorder sequence with a
+    //callable object taking a const elemType&, following the
+    //threads.
+
+    template <class inputIterator>
+    void buildTree(inputIterator first, inputIterator last);
+    //Function to replace the tree by a perfectly balanced tree
+    //of the distinct items in [first, last), which do not have
+    //to be sorted.
+    //Postcondition: The nodes are stored in inorder sequence;
+    // the vector holds no free nodes. Throws
+    // length_error, before changing the tree, if
+    // there are more than 2^31 - 1 distinct items.
+
+    bool isEmpty() const;
+    int treeNodeCount() const;
+    int treeHeight() const;
+    //Postcondition: Return whether the tree is empty, the
+    // number of nodes and the height of the tree.
+
+    size_t memoryBytes() const;
+    //Postcondition: Returns the bytes taken by the node vector,
+    // including free nodes and unused capacity.
+
+    void shrinkToFit();
+    //Function to release unused capacity of the node vector.
+
+    void destroyTree();
+    //Postcondition: The tree is empty and the nodes are freed.
+
+    template <class inputIterator>
+    compactSearchTreeType(inputIterator first, inputIterator last,
+                          const compareType& compare = compareType());
+    //Constructor that builds the tree from [first, last)
+    //with buildTree.
+
+    explicit compactSearchTreeType(const compareType& compare);
+    //Constructor of an empty tree ordered by compare.
+
+    compactSearchTreeType();
+    //Default constructor
+
+private:
+    static const uint32_t threadBit = 0x80000000u;
+    static const uint32_t indexMask = 0x7fffffffu;
+
+    static bool isThread(uint32_t link) { return (link & threadBit) != 0; }
+    static uint32_t child(uint32_t link) { return isThread(link) ? 0 : link; }
+    //Postcondition: Returns the index of the child the link
+    // points to, or 0 if the link is a thread.
+
+    template <class itemType>
+    bool insertItem(itemType&& item);
+    //Function to do insert for a copied or moved item.
+
+    uint32_t newNode(uint32_t left, uint32_t right);
+    //Function to get a node from the free list or the end of
+    //the vector; its info is set by the caller.
+    //Postcondition: Returns the index of the node, with its
+    // links set to left and right. Throws length_error
+    // if the index would reach threadBit.
+
+    void freeNode(uint32_t p);
+    //Postcondition: Node p is on the free list.
+
+    void removeNode(uint32_t parent, uint32_t p);
+    //Function to unlink node p, which has at most one child,
+    //from its parent (0 if p is the root), fixing the thread
+    //that pointed to p.
+    //Postcondition: p is on the free list.
+
+    uint32_t buildBalanced(size_t first, size_t last);
+    //Function to link the nodes[first..last-1], which hold the
+    //items in inorder sequence, into a perfectly balanced tree.
+    //Postcondition: Returns the index of its root; the links
+    // of nodes without a child are threads to
+    // their inorder neighbours.
+
+    vector<compactNodeType<elemType> > nodes;   // nodes[0] is not used
+    uint32_t root;                              // Index of the root node
+    uint32_t freeList;                          // First free node, linked
+                                                // through lLink
+    int count;                                  // Number of nodes in the tree
+    compareType comp;                           // Order of the keys
+};
+
+template <class elemType, class compareType>
+compactSearchTreeType<elemType, compareType>::compactSearchTreeType()
+    : root(0), freeList(0), count(0)
+{
+}
+
+template <class elemType, class compareType>
+compactSearchTreeType<elemType, compareType>::compactSearchTreeType(const compareType& compare)
+    : root(0), freeList(0), count(0), comp(compare)
+{
+}
+
+template <class elemType, class compareType>
+template <class inputIterator>
+compactSearchTreeType<elemType, compareType>::compactSearchTreeType
+                (inputIterator first, inputIterator last, const compareType& compare)
+    : root(0), freeList(0), count(0), comp(compare)
+{
+    buildTree(first, last);
+}
+
+template <class elemType, class compareType>
+bool compactSearchTreeType<elemType, compareType>::isEmpty() const
+{
+    return (root == 0);
+}
+
+template <class elemType, class compareType>
+int compactSearchTreeType<elemType, compareType>::treeNodeCount() const
+{
+    return count;
+}
+
+template <class elemType, class compareType>
+size_t compactSearchTreeType<elemType, compareType>::memoryBytes() const
+{
+    return nodes.capacity() * sizeof(compactNodeType<elemType>);
+}
+
+template <class elemType, class compareType>
+void compactSearchTreeType<elemType, compareType>::shrinkToFit()
+{
+    nodes.shrink_to_fit();
+}
+
+template <class elemType, class compareType>
+void compactSearchTreeType<elemType, compareType>::destroyTree()
+{
+    vector<compactNodeType<elemType> >().swap(nodes);
+    root = 0;
+    freeList = 0;
+    count = 0;
+}
+
+template <class elemType, class compareType>
+int compactSearchTreeType<elemType, compareType>::treeHeight() const
+// Depth-first with a stack of (node, depth) pairs.
+{
+    vector<pair<uint32_t, int> > stack;
+    int height = 0;
+
+    if (root != 0)
+        stack.push_back(make_pair(root, 1));
+    while (!stack.empty())
+    {
+        uint32_t p = stack.back().first;
+        int depth = stack.back().second;
+
+        stack.pop_back();
+        if (depth > height)
+            height = depth;
+        if (child(nodes[p].lLink) != 0)
+            stack.push_back(make_pair(nodes[p].lLink, depth + 1));
+        if (child(nodes[p].rLink) != 0)
+            stack.push_back(make_pair(nodes[p].rLink, depth + 1));
+    }
+    return height;
+} //end treeHeight
+
+template <class elemType, class compareType>
+bool compactSearchTreeType<elemType, compareType>::search(const elemType& searchItem) const
+{
+    uint32_t current = root;
+    int order;
+
+    if (root == 0)
+        reportTreeEvent(searchEmptyTree);
+    while (current != 0)
+    {
+        order = treeCompare(comp, nodes[current].info, searchItem);
+        if (order == 0)
+            return true;
+        else if (order > 0)
+            current = child(nodes[current].lLink);
+        else
+            current = child(nodes[current].rLink);
+    }
+    return false;
+} //end search
+
+template <class elemType, class compareType>
+uint32_t compactSearchTreeType<elemType, compareType>::newNode(uint32_t left, uint32_t right)
+{
+    uint32_t p;
+
+    if (freeList != 0)
+    {
+        p = freeList;
+        freeList = nodes[p].lLink;
+    }
+    else
+    {
+        if (nodes.size() > indexMask)
+            throw length_error("compactSearchTreeType: more than 2^31 - 1 nodes");
+        if (nodes.empty())
+            nodes.resize(1);            // index 0 means no node
+        p = static_cast<uint32_t>(nodes.size());
+        nodes.resize(nodes.size() + 1);
+    }
+    nodes[p].lLink = left;
+    nodes[p].rLink = right;
+    return p;
+} //end newNode
+
+template <class elemType, class compareType>
+void compactSearchTreeType<elemType, compareType>::freeNode(uint32_t p)
+{
+    nodes[p].info = elemType();         // drop what the item holds
+    nodes[p].lLink = freeList;
+    freeList = p;
+}
+
+template <class elemType, class compareType>
+template <class itemType>
+bool compactSearchTreeType<elemType, compareType>::insertItem(itemType&& item)
+// The new node is a leaf: its threads take over the thread of its
+// parent on that side, and the parent's link on the other side of the
+// new node becomes a thread back to the parent.
+{
+    uint32_t current = root;
+    uint32_t p;
+    int order = 0;
+
+    while (current != 0)
+    {
+        order = treeCompare(comp, nodes[current].info, item);
+        if (order == 0)
+        {
+            reportTreeEvent(insertDuplicate);
+            return false;
+        }
+        uint32_t next = child(order > 0 ? nodes[current].lLink : nodes[current].rLink);
+        if (next == 0)
+            break;
+        current = next;
+    }
+
+    if (current == 0)
+        p = root = newNode(threadBit, threadBit);
+    else if (order > 0)
+    {
+        p = newNode(nodes[current].lLink, current | threadBit);
+        nodes[current].lLink = p;
+    }
+    else
+    {
+        p = newNode(current | threadBit, nodes[current].rLink);
+        nodes[current].rLink = p;
+    }
+    nodes[p].info = std::forward<itemType>(item);
+    count++;
+    return true;
+} //end insertItem
+
+template <class elemType, class compareType>
+bool compactSearchTreeType<elemType, compareType>::insert(const elemType& insertItem)
+{
+    return this->insertItem(insertItem);
+}
+
+template <class elemType, class compareType>
+bool compactSearchTreeType<elemType, compareType>::insert(elemType&& insertItem)
+{
+    return this->insertItem(std::move(insertItem));
+}
+
+template <class elemType, class compareType>
+void compactSearchTreeType<elemType, compareType>::removeNode(uint32_t parent, uint32_t p)
+// A leaf is replaced by the thread it had on the side of its parent.
+// A node with one child is replaced by that child, and the thread in
+// the child's subtree that pointed back to p (from its largest node
+// for a left child, its smallest for a right child) is moved on to
+// p's other neighbour.
+{
+    uint32_t left = child(nodes[p].lLink);
+    uint32_t right = child(nodes[p].rLink);
+    uint32_t replacement;
+
+    if (left == 0 && right == 0)
+        replacement = (parent != 0 && nodes[parent].lLink == p) ? nodes[p].lLink : nodes[p].rLink;
+    else if (right == 0)
+    {
+        uint32_t q = left;
+
+        while (child(nodes[q].rLink) != 0)
+            q = nodes[q].rLink;
+        nodes[q].rLink = nodes[p].rLink;
+        replacement = left;
+    }
+    else
+    {
+        uint32_t q = right;
+
+        while (child(nodes[q].lLink) != 0)
+            q = nodes[q].lLink;
+        nodes[q].lLink = nodes[p].lLink;
+        replacement = right;
+    }
+
+    if (parent == 0)
+        root = child(replacement);
+    else if (nodes[parent].lLink == p)
+        nodes[parent].lLink = replacement;
+    else
+        nodes[parent].rLink = replacement;
+    freeNode(p);
+} //end removeNode
+
+template <class elemType, class compareType>
+bool compactSearchTreeType<elemType, compareType>::deleteNode(const elemType& deleteItem)
+// A node with two children takes the info of its inorder successor,
+// which has no left child, and the successor is removed instead.
+{
+    uint32_t current = root;
+    uint32_t parent = 0;
+    int order;
+
+    if (root == 0)
+    {
+        reportTreeEvent(deleteEmptyTree);
+        return false;
+    }
+    while (current != 0)
+    {
+        order = treeCompare(comp, nodes[current].info, deleteItem);
+        if (order == 0)
+            break;
+        parent = current;
+        current = child(order > 0 ? nodes[current].lLink : nodes[current].rLink);
+    }
+    if (current == 0)
+    {
+        reportTreeEvent(deleteNotFound);
+        return false;
+    }
+
+    if (child(nodes[current].lLink) != 0 && child(nodes[current].rLink) != 0)
+    {
+        uint32_t successor = nodes[current].rLink;
+
+        parent = current;
+        while (child(nodes[successor].lLink) != 0)
+        {
+            parent = successor;
+            successor = nodes[successor].lLink;
+        }
+        nodes[current].info = std::move(nodes[successor].info);
+        current = successor;
+    }
+    removeNode(parent, current);
+    count--;
+    return true;
+} //end deleteNode
+
+template <class elemType, class compareType>
+template <class visitor>
+void compactSearchTreeType<elemType, compareType>::inorderTraversal(visitor&& visit) const
+// From a node, the next one is its successor thread, or the smallest
+// node of its right subtree.
+{
+    uint32_t p = root;
+
+    if (p == 0)
+        return;
+    while (child(nodes[p].lLink) != 0)
+        p = nodes[p].lLink;
+    while (p != 0)
+    {
+        visit(static_cast<const elemType&>(nodes[p].info));
+        if (isThread(nodes[p].rLink))
+            p = nodes[p].rLink & indexMask;
+        else
+        {
+            p = nodes[p].rLink;
+            while (child(nodes[p].lLink) != 0)
+                p = nodes[p].lLink;
+        }
+    }
+} //end inorderTraversal
+
+template <class elemType, class compareType>
+template <class inputIterator>
+void compactSearchTreeType<elemType, compareType>::buildTree(inputIterator first, inputIterator last)
+{
+    vector<elemType> items(first, last);
+
+    if (!is_sorted(items.begin(), items.end(), comp))
+        sort(items.begin(), items.end(), comp);
+    items.erase(unique(items.begin(), items.end(),
+                       [this](const elemType& a, const elemType& b) { return !comp(a, b); }),
+                items.end());
+
+    if (items.size() > indexMask)
+        throw length_error("compactSearchTreeType: more than 2^31 - 1 nodes");
+    destroyTree();
+    if (items.empty())
+        return;
+    nodes.resize(items.size() + 1);
+    for (size_t i = 0; i < items.size(); i++)
+        nodes[i + 1].info = std::move(items[i]);
+    count = static_cast<int>(items.size());
+    root = buildBalanced(1, items.size() + 1);
+} //end buildTree
+
+template <class elemType, class compareType>
+uint32_t compactSearchTreeType<elemType, compareType>::buildBalanced(size_t first, size_t last)
+// Node i sits at its inorder position, so its neighbours are i - 1
+// and i + 1; index 0 and the one past the end become 0.
+{
+    uint32_t mid = static_cast<uint32_t>(first + (last - first) / 2);
+    uint32_t successor = (mid + 1 < nodes.size()) ? mid + 1 : 0;
+
+    if (mid > first)
+        nodes[mid].lLink = buildBalanced(first, mid);
+    else
+        nodes[mid].lLink = (mid - 1) | threadBit;
+    if (mid + 1 < last)
+        nodes[mid].rLink = buildBalanced(mid + 1, last);
+    else
+        nodes[mid].rLink = successor | threadBit;
+    return mid;
+} //end buildBalanced
+
+#endif
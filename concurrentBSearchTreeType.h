@@ -0,0 +1,324 @@
+#ifndef CONCURRENTBSEARCHTREETYPE_H
+#define CONCURRENTBSEARCHTREETYPE_H
+
+/* A binary search tree that can be searched by any number of threads
+   while other threads insert and delete.
+    1. Readers (search, inorderTraversal) take no lock. They follow
+    atomic links and run inside an epochGuard, so no node they can
+    still reach is deleted under them (see epochReclamation.h).
+    2. Writers (insert, deleteNode) are serialized by a mutex.
+    3. The info of a node never changes once the node is linked into
+    the tree. Deleting a node with two children therefore links in a
+    new node holding the predecessor instead of copying the
+    predecessor's info into place.
+    4. Moving the predecessor up can make a concurrent search for it
+    miss, so deletes bump a version counter (odd while the tree is
+    being changed). A search that does not find its item re-checks
+    the version and retries if a delete happened meanwhile; after a
+    few retries it takes the writer lock.
+   Inserts never make another search miss, so they do not touch the
+   version.
+   Like bSearchTreeType, the tree takes a comparator (less<elemType>
+   by default) and each level asks it once for the order, through
+   treeCompare.
+*/
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include "epochReclamation.h"
+#include "treeCompare.h"
+
+using namespace std;
+
+// Definition of the node
+template <class elemType>
+struct concurrentNodeType
+{
+    elemType info;                                      // Store the data; never changes
+    atomic<concurrentNodeType<elemType>*> lLink;        // Pointer to the left child
+    atomic<concurrentNodeType<elemType>*> rLink;        // Pointer to the right child
+
+    concurrentNodeType(const elemType& item, concurrentNodeType<elemType> *left,
+                       concurrentNodeType<elemType> *right)
+        : info(item), lLink(left), rLink(right) {}
+};
+
+template <class elemType, class compareType = less<elemType> >
+class concurrentBSearchTreeType
+{
+public:
+    bool search(const elemType& searchItem) const;
+    //Function to determine if searchItem is in the binary
+    //search tree. Safe to call concurrently with any other
+    //member function except destroyTree and the destructor.
+    //Postcondition: Returns true if searchItem is found in
+    // the binary search tree; otherwise,
+    // returns false.
+
+    bool insert(const elemType& insertItem);
+    //Function to insert insertItem in the binary search tree.
+    //Postcondition: If there is no node in the binary search
+    // tree that has the same info as insertItem, a
+    // node with the info insertItem is inserted
+    // and true is returned; otherwise, false is
+    // returned.
+
+    bool deleteNode(const elemType& deleteItem);
+    //Function to delete deleteItem from the binary search tree.
+    //The deleted nodes are handed to the epoch domain and
+    //deleted once no reader can reach them.
+    //Postcondition: If a node with the same info as
+    // deleteItem is found, it is deleted and true
+    // is returned; otherwise, false is returned.
+
+    template <class visitor>
+    void inorderTraversal(visitor&& visit) const;
+    //Function to visit the items in inorder sequence with a
+    //callable object taking a const elemType&. Runs without
+    //the writer lock; items inserted or deleted during the
+    //traversal may or may not be visited.
+
+    bool isEmpty() const;
+    int treeNodeCount() const;
+    //Postcondition: Return whether the tree is empty and the
+    // number of nodes in the tree.
+
+    void destroyTree();
+    //Function to destroy the binary search tree. No other
+    //thread may use the tree during the call.
+    //Postcondition: Every node is deallocated; the tree is empty.
+
+    explicit concurrentBSearchTreeType(const compareType& compare);
+    //Constructor of an empty tree ordered by compare.
+
+    concurrentBSearchTreeType();
+    //Default constructor
+
+    ~concurrentBSearchTreeType();
+    //Destructor
+
+    concurrentBSearchTreeType(const concurrentBSearchTreeType<elemType, compareType>&) = delete;
+    const concurrentBSearchTreeType<elemType, compareType>& operator=
+                (const concurrentBSearchTreeType<elemType, compareType>&) = delete;
+
+private:
+    static const int maxRetries = 4;
+
+    bool findUnlocked(const elemType& searchItem) const;
+    //Postcondition: Returns true if searchItem is reached by a
+    // search that takes no lock.
+
+    atomic<concurrentNodeType<elemType>*> root;     // Pointer to the root node
+    atomic<unsigned long> version;                  // Odd while a delete is in progress
+    atomic<int> count;                              // Number of nodes
+    mutable mutex writerLock;                       // Serializes the writers
+    compareType comp;                               // Order of the keys
+};
+
+template <class elemType, class compareType>
+concurrentBSearchTreeType<elemType, compareType>::concurrentBSearchTreeType()
+    : root(nullptr), version(0), count(0)
+{
+}
+
+template <class elemType, class compareType>
+concurrentBSearchTreeType<elemType, compareType>::concurrentBSearchTreeType(const compareType& compare)
+    : root(nullptr), version(0), count(0), comp(compare)
+{
+}
+
+template <class elemType, class compareType>
+concurrentBSearchTreeType<elemType, compareType>::~concurrentBSearchTreeType()
+{
+    destroyTree();
+}
+
+template <class elemType, class compareType>
+bool concurrentBSearchTreeType<elemType, compareType>::isEmpty() const
+{
+    return (root.load(memory_order_acquire) == nullptr);
+}
+
+template <class elemType, class compareType>
+int concurrentBSearchTreeType<elemType, compareType>::treeNodeCount() const
+{
+    return count.load(memory_order_relaxed);
+}
+
+template <class elemType, class compareType>
+bool concurrentBSearchTreeType<elemType, compareType>::findUnlocked(const elemType& searchItem) const
+{
+    concurrentNodeType<elemType> *current = root.load(memory_order_acquire);
+    int order;
+
+    while (current != nullptr)
+    {
+        order = treeCompare(comp, current->info, searchItem);
+        if (order == 0)
+            return true;
+        else if (order > 0)
+            current = current->lLink.load(memory_order_acquire);
+        else
+            current = current->rLink.load(memory_order_acquire);
+    }
+    return false;
+}
+
+template <class elemType, class compareType>
+bool concurrentBSearchTreeType<elemType, compareType>::search(const elemType& searchItem) const
+// A hit is always correct: the node was linked in when it was reached.
+// A miss is only trusted if no delete overlapped the search.
+{
+    epochGuard guard;
+    unsigned long before;
+
+    for (int attempt = 0; attempt < maxRetries; attempt++)
+    {
+        before = version.load(memory_order_acquire);
+        if (findUnlocked(searchItem))
+            return true;
+        atomic_thread_fence(memory_order_acquire);
+        if ((before & 1) == 0 && version.load(memory_order_relaxed) == before)
+            return false;
+    }
+
+    lock_guard<mutex> lock(writerLock);
+    return findUnlocked(searchItem);
+} //end search
+
+template <class elemType, class compareType>
+bool concurrentBSearchTreeType<elemType, compareType>::insert(const elemType& insertItem)
+// The new node is fully built before the release store that links it
+// in, so a reader that sees the link also sees its info.
+{
+    lock_guard<mutex> lock(writerLock);
+    atomic<concurrentNodeType<elemType>*> *link = &root;
+    concurrentNodeType<elemType> *current = root.load(memory_order_relaxed);
+    int order;
+
+    while (current != nullptr)
+    {
+        order = treeCompare(comp, current->info, insertItem);
+        if (order == 0)
+            return false;
+        else if (order > 0)
+            link = &current->lLink;
+        else
+            link = &current->rLink;
+        current = link->load(memory_order_relaxed);
+    }
+
+    link->store(new concurrentNodeType<elemType>(insertItem, nullptr, nullptr),
+                memory_order_release);
+    count.fetch_add(1, memory_order_relaxed);
+    return true;
+} //end insert
+
+template <class elemType, class compareType>
+bool concurrentBSearchTreeType<elemType, compareType>::deleteNode(const elemType& deleteItem)
+{
+    lock_guard<mutex> lock(writerLock);
+    atomic<concurrentNodeType<elemType>*> *link = &root;
+    concurrentNodeType<elemType> *current = root.load(memory_order_relaxed);
+    concurrentNodeType<elemType> *left, *right;
+    int order;
+
+    while (current != nullptr && (order = treeCompare(comp, current->info, deleteItem)) != 0)
+    {
+        if (order > 0)
+            link = &current->lLink;
+        else
+            link = &current->rLink;
+        current = link->load(memory_order_relaxed);
+    }
+    if (current == nullptr)
+        return false;
+
+    version.fetch_add(1, memory_order_relaxed);     // now odd
+    atomic_thread_fence(memory_order_release);
+
+    left = current->lLink.load(memory_order_relaxed);
+    right = current->rLink.load(memory_order_relaxed);
+    if (left == nullptr)
+        link->store(right, memory_order_release);
+    else if (right == nullptr)
+        link->store(left, memory_order_release);
+    else
+    {
+        // Find the predecessor and the link that points to it.
+        atomic<concurrentNodeType<elemType>*> *predLink = &current->lLink;
+        concurrentNodeType<elemType> *pred = left;
+        while (pred->rLink.load(memory_order_relaxed) != nullptr)
+        {
+            predLink = &pred->rLink;
+            pred = predLink->load(memory_order_relaxed);
+        }
+
+        // Link in a copy of the predecessor in place of current,
+        // then unlink the predecessor from the left subtree.
+        concurrentNodeType<elemType> *replacement;
+        if (pred == left)
+            replacement = new concurrentNodeType<elemType>(pred->info,
+                                pred->lLink.load(memory_order_relaxed), right);
+        else
+        {
+            replacement = new concurrentNodeType<elemType>(pred->info, left, right);
+            predLink->store(pred->lLink.load(memory_order_relaxed), memory_order_release);
+        }
+        link->store(replacement, memory_order_release);
+        epochDomain::instance().retire(pred);
+    }
+    epochDomain::instance().retire(current);
+
+    version.fetch_add(1, memory_order_release);     // even again
+    count.fetch_sub(1, memory_order_relaxed);
+    return true;
+} //end deleteNode
+
+template <class elemType, class compareType>
+template <class visitor>
+void concurrentBSearchTreeType<elemType, compareType>::inorderTraversal(visitor&& visit) const
+{
+    epochGuard guard;
+    vector<concurrentNodeType<elemType>*> stack;
+    concurrentNodeType<elemType> *p = root.load(memory_order_acquire);
+
+    while (p != nullptr || !stack.empty())
+    {
+        while (p != nullptr)
+        {
+            stack.push_back(p);
+            p = p->lLink.load(memory_order_acquire);
+        }
+        p = stack.back();
+        stack.pop_back();
+        visit(static_cast<const elemType&>(p->info));
+        p = p->rLink.load(memory_order_acquire);
+    }
+} //end inorderTraversal
+
+template <class elemType, class compareType>
+void concurrentBSearchTreeType<elemType, compareType>::destroyTree()
+{
+    vector<concurrentNodeType<elemType>*> stack;
+    concurrentNodeType<elemType> *p = root.load(memory_order_relaxed);
+
+    if (p != nullptr)
+        stack.push_back(p);
+    while (!stack.empty())
+    {
+        p = stack.back();
+        stack.pop_back();
+        if (p->lLink.load(memory_order_relaxed) != nullptr)
+            stack.push_back(p->lLink.load(memory_order_relaxed));
+        if (p->rLink.load(memory_order_relaxed) != nullptr)
+            stack.push_back(p->rLink.load(memory_order_relaxed));
+        delete p;
+    }
+    root.store(nullptr, memory_order_relaxed);
+    count.store(0, memory_order_relaxed);
+} //end destroyTree
+
+#endif
@@ -0,0 +1,248 @@
+// Epoch-based memory reclamation for data structures whose readers
+// do not take locks.
+//
+// A reader wraps every access in an epochGuard. A writer that unlinks
+// a node calls epochDomain::instance().retire(node) instead of deleting
+// it; the node is deleted once every reader that might still hold a
+// pointer to it has left its guard. The domain keeps a global epoch;
+// a guard announces the epoch it started in, the global epoch only
+// advances when every active reader has announced the current one,
+// and a node retired in epoch e is deleted once the global epoch
+// reaches e + 2.
+#ifndef EPOCHRECLAMATION_H
+#define EPOCHRECLAMATION_H
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+class epochDomain
+{
+public:
+    static epochDomain& instance();
+    //Postcondition: Returns the process-wide domain.
+
+    void enter();
+    //Function to start a read-side critical section on the
+    //calling thread. Calls may be nested.
+
+    void leave();
+    //Function to end the read-side critical section started
+    //by the matching call of enter.
+
+    template <class nodeType>
+    void retire(nodeType *p);
+    //Function to hand over a node that is no longer reachable
+    //from the data structure.
+    //Postcondition: p is deleted once no reader can hold it.
+
+    void reclaim();
+    //Function to try to advance the epoch and delete the nodes
+    //that are safe to delete.
+
+    ~epochDomain();
+
+private:
+    static const size_t maxThreads = 256;
+    static const unsigned long idle = ~0UL;
+    static const size_t reclaimThreshold = 64;
+
+    struct alignas(64) threadSlot
+    {
+        atomic<unsigned long> epoch;    // Epoch announced by the reader, or idle
+        atomic<bool> inUse;             // Slot owned by a live thread
+    };
+
+    struct threadHandle
+    {
+        threadSlot *slot;               // Slot of the thread, taken on first use
+        int depth;                      // Nesting depth of enter calls
+
+        threadHandle();
+        ~threadHandle();
+    };
+
+    struct retiredNode
+    {
+        void *node;
+        void (*deleter)(void*);
+        unsigned long epoch;            // Global epoch when the node was retired
+    };
+
+    template <class nodeType>
+    static void deleteNode(void *p);
+
+    static threadHandle& handle();
+    //Postcondition: Returns the handle of the calling thread.
+
+    threadSlot* acquireSlot();
+    //Postcondition: Returns a free slot, now owned by the caller.
+
+    bool tryAdvance();
+    //Function to advance the global epoch if every active reader
+    //has announced it. Called with retiredLock held.
+    //Postcondition: Returns true if the epoch was advanced.
+
+    epochDomain();
+
+    threadSlot slots[maxThreads];
+    atomic<unsigned long> globalEpoch;
+    mutex retiredLock;                  // Protects retired
+    vector<retiredNode> retired;        // Nodes waiting to be deleted
+};
+
+// Guard object for a read-side critical section
+class epochGuard
+{
+public:
+    epochGuard() { epochDomain::instance().enter(); }
+    ~epochGuard() { epochDomain::instance().leave(); }
+    epochGuard(const epochGuard&) = delete;
+    const epochGuard& operator=(const epochGuard&) = delete;
+};
+
+inline epochDomain& epochDomain::instance()
+{
+    static epochDomain domain;
+
+    return domain;
+}
+
+inline epochDomain::epochDomain()
+{
+    for (size_t i = 0; i < maxThreads; i++)
+    {
+        slots[i].epoch.store(idle);
+        slots[i].inUse.store(false);
+    }
+    globalEpoch.store(0);
+}
+
+inline epochDomain::~epochDomain()
+{
+    for (size_t i = 0; i < retired.size(); i++)
+        retired[i].deleter(retired[i].node);
+}
+
+inline epochDomain::threadHandle::threadHandle()
+{
+    slot = nullptr;
+    depth = 0;
+}
+
+inline epochDomain::threadHandle::~threadHandle()
+{
+    if (slot != nullptr)
+    {
+        slot->epoch.store(idle, memory_order_release);
+        slot->inUse.store(false, memory_order_release);
+    }
+}
+
+inline epochDomain::threadHandle& epochDomain::handle()
+{
+    static thread_local threadHandle threadState;
+
+    return threadState;
+}
+
+inline epochDomain::threadSlot* epochDomain::acquireSlot()
+{
+    for (size_t i = 0; i < maxThreads; i++)
+    {
+        bool expected = false;
+        if (!slots[i].inUse.load(memory_order_relaxed)
+            && slots[i].inUse.compare_exchange_strong(expected, true))
+            return &slots[i];
+    }
+    throw runtime_error("epochDomain: too many reader threads");
+}
+
+inline void epochDomain::enter()
+{
+    threadHandle& state = handle();
+
+    if (state.slot == nullptr)
+        state.slot = acquireSlot();
+    if (state.depth++ == 0)
+    {
+        // The announcement must be visible to tryAdvance before any
+        // shared pointer is read, hence the full fence.
+        state.slot->epoch.store(globalEpoch.load(memory_order_relaxed), memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+    }
+}
+
+inline void epochDomain::leave()
+{
+    threadHandle& state = handle();
+
+    if (--state.depth == 0)
+        state.slot->epoch.store(idle, memory_order_release);
+}
+
+template <class nodeType>
+void epochDomain::deleteNode(void *p)
+{
+    delete static_cast<nodeType*>(p);
+}
+
+template <class nodeType>
+void epochDomain::retire(nodeType *p)
+{
+    bool full;
+
+    {
+        lock_guard<mutex> lock(retiredLock);
+        retiredNode entry = {p, &deleteNode<nodeType>, globalEpoch.load(memory_order_relaxed)};
+        retired.push_back(entry);
+        full = (retired.size() >= reclaimThreshold);
+    }
+    if (full)
+        reclaim();
+}
+
+inline bool epochDomain::tryAdvance()
+{
+    unsigned long current = globalEpoch.load(memory_order_relaxed);
+
+    atomic_thread_fence(memory_order_seq_cst);
+    for (size_t i = 0; i < maxThreads; i++)
+    {
+        unsigned long announced = slots[i].epoch.load(memory_order_acquire);
+        if (announced != idle && announced != current)
+            return false;
+    }
+    globalEpoch.store(current + 1, memory_order_release);
+    return true;
+}
+
+inline void epochDomain::reclaim()
+{
+    vector<retiredNode> ready;
+
+    {
+        lock_guard<mutex> lock(retiredLock);
+        tryAdvance();
+
+        unsigned long current = globalEpoch.load(memory_order_relaxed);
+        size_t kept = 0;
+        for (size_t i = 0; i < retired.size(); i++)
+        {
+            if (retired[i].epoch + 2 <= current)
+                ready.push_back(retired[i]);
+            else
+                retired[kept++] = retired[i];
+        }
+        retired.resize(kept);
+    }
+
+    for (size_t i = 0; i < ready.size(); i++)
+        ready[i].deleter(ready[i].node);
+}
+
+#endif
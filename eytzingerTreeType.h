@@ -0,0 +1,367 @@
+#ifndef EYTZINGERTREETYPE_H
+#define EYTZINGERTREETYPE_H
+
+/* A frozen, read-only copy of a binary search tree for lookup-heavy
+   workloads. The items are stored in one array in Eytzinger (level
+   order) layout: the root is at index 1 and the children of the item
+   at index k are at 2k and 2k+1. A search walks down the array with
+   no pointers to chase; the 16 descendants four levels below the
+   current item are contiguous (64 bytes for 4-byte items), and they
+   are prefetched while the current level is compared.
+   The snapshot does not change when the tree it was built from does.
+   It keeps the order of the tree, compareType; searchBatch uses vector
+   instructions only for the natural order (less<>, less<T>).
+*/
+
+#include <iostream>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include "bSearchTreeType.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define EYTZINGER_AVX2
+#endif
+
+using namespace std;
+
+template <class elemType, class compareType = less<elemType> >
+class eytzingerTreeType
+{
+public:
+    bool search(const elemType& searchItem) const;
+    //Function to determine if searchItem is in the snapshot.
+    //Postcondition: Returns true if searchItem is found;
+    // otherwise, returns false.
+
+    void searchBatch(const elemType* keys, size_t n, bool* out) const;
+    //Function to search for the n items keys[0..n-1].
+    //The searches are interleaved in groups; for int and
+    //long long items in the natural order the group is
+    //compared with AVX2 vector instructions when the
+    //processor supports them (checked at run time), otherwise
+    //scalar code is used.
+    //Postcondition: out[i] is true if keys[i] is found;
+    // otherwise, out[i] is false.
+
+    static bool vectorSearch();
+    //Postcondition: Returns true if searchBatch uses AVX2 for
+    // elemType on this processor.
+
+    bool isEmpty() const;
+    //Postcondition: Returns true if the snapshot holds no items.
+
+    int treeNodeCount() const;
+    //Postcondition: Returns the number of items in the snapshot.
+
+    template <class allocType>
+    void build(const bSearchTreeType<elemType, allocType, compareType>& tree);
+    //Function to replace the snapshot by the items of tree.
+    //Postcondition: The snapshot holds the items of tree and
+    // searches with its comparator.
+
+    template <class allocType>
+    explicit eytzingerTreeType(const bSearchTreeType<elemType, allocType, compareType>& tree);
+    //Constructor that builds the snapshot from tree.
+
+    eytzingerTreeType();
+    //Default constructor
+
+private:
+    size_t finish(size_t k) const;
+    //Function to turn the index reached at the bottom of the
+    //layout into the index of the smallest item not less
+    //than the key searched for.
+    //Postcondition: Returns that index, or 0 if every item is
+    // less than the key.
+
+    void scalarBatch(const elemType* keys, size_t n, bool* out) const;
+    //searchBatch without vector instructions.
+
+#ifdef EYTZINGER_AVX2
+    __attribute__((target("avx2")))
+    void avx2Batch(const int* keys, size_t n, bool* out) const;
+    __attribute__((target("avx2")))
+    void avx2Batch(const long long* keys, size_t n, bool* out) const;
+    //searchBatch for 8 int or 4 long long keys at a time.
+#endif
+
+    template <class iteratorType>
+    void fill(iteratorType& current, size_t k);
+    //Function to store the items, in inorder sequence, in the
+    //subtree of the layout rooted at index k.
+    //Postcondition: current has moved past the items stored.
+
+    vector<elemType> items;             // items[1..count]; items[0] is unused
+    size_t count;                       // Number of items in the snapshot
+    compareType comp;                   // Order of the items
+};
+
+template <class elemType, class compareType>
+eytzingerTreeType<elemType, compareType>::eytzingerTreeType()
+{
+    count = 0;
+}
+
+template <class elemType, class compareType>
+template <class allocType>
+eytzingerTreeType<elemType, compareType>::eytzingerTreeType
+                (const bSearchTreeType<elemType, allocType, compareType>& tree)
+{
+    count = 0;
+    build(tree);
+}
+
+template <class elemType, class compareType>
+template <class allocType>
+void eytzingerTreeType<elemType, compareType>::build
+                (const bSearchTreeType<elemType, allocType, compareType>& tree)
+// An inorder walk of the tree yields the items in sorted order; they
+// are written to the layout in inorder sequence of its implicit tree.
+{
+    typename bSearchTreeType<elemType, allocType, compareType>::const_iterator current = tree.begin();
+
+    comp = tree.keyCompare();
+    count = tree.treeNodeCount();
+    items.assign(count + 1, elemType());
+    fill(current, 1);
+} //end build
+
+template <class elemType, class compareType>
+template <class iteratorType>
+void eytzingerTreeType<elemType, compareType>::fill(iteratorType& current, size_t k)
+// The recursion depth is the height of the layout, which is
+// ceil(log2(count + 1)).
+{
+    if (k <= count)
+    {
+        fill(current, 2 * k);
+        items[k] = *current;
+        ++current;
+        fill(current, 2 * k + 1);
+    }
+}
+
+template <class elemType, class compareType>
+bool eytzingerTreeType<elemType, compareType>::isEmpty() const
+{
+    return (count == 0);
+}
+
+template <class elemType, class compareType>
+int eytzingerTreeType<elemType, compareType>::treeNodeCount() const
+{
+    return static_cast<int>(count);
+}
+
+template <class elemType, class compareType>
+bool eytzingerTreeType<elemType, compareType>::search(const elemType& searchItem) const
+// The loop always runs to the bottom of the layout and the next index
+// is computed without a branch: go right (2k+1) while the item is
+// less than searchItem, otherwise left (2k). The path taken is then the binary
+// representation of k; shifting out the trailing right turns and the
+// last left turn gives the smallest item not less than searchItem.
+{
+    const elemType *base = items.data();
+    size_t k = 1;
+
+    if (count == 0)
+    {
+        reportTreeEvent(searchEmptyTree);
+        return false;
+    }
+
+    while (k <= count)
+    {
+#if defined(__GNUC__)
+        __builtin_prefetch(base + 16 * k);
+#endif
+        k = 2 * k + comp(base[k], searchItem);
+    }
+
+    k = finish(k);
+    return (k != 0 && !comp(searchItem, base[k]));
+} //end search
+
+template <class elemType, class compareType>
+size_t eytzingerTreeType<elemType, compareType>::finish(size_t k) const
+{
+    while (k & 1)
+        k >>= 1;
+    return k >> 1;
+}
+
+template <class elemType, class compareType>
+bool eytzingerTreeType<elemType, compareType>::vectorSearch()
+{
+#ifdef EYTZINGER_AVX2
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+
+    return avx2 && isNaturalOrder<compareType>::value
+           && (is_same<elemType, int>::value || is_same<elemType, long long>::value);
+#else
+    return false;
+#endif
+}
+
+template <class elemType, class compareType>
+void eytzingerTreeType<elemType, compareType>::searchBatch(const elemType* keys, size_t n, bool* out) const
+{
+#ifdef EYTZINGER_AVX2
+    // The vector code keeps indices in 32-bit lanes.
+    if (vectorSearch() && count < (size_t(1) << 30))
+    {
+        if constexpr (isNaturalOrder<compareType>::value
+                      && (is_same<elemType, int>::value || is_same<elemType, long long>::value))
+        {
+            avx2Batch(keys, n, out);
+            return;
+        }
+    }
+#endif
+    scalarBatch(keys, n, out);
+}
+
+template <class elemType, class compareType>
+void eytzingerTreeType<elemType, compareType>::scalarBatch(const elemType* keys, size_t n, bool* out) const
+// Every search of a group runs the same number of rounds (the loop of
+// search stops at the bottom of the layout, whose depth differs by at
+// most one between paths), so the group advances in lock step.
+{
+    const size_t groupSize = 16;
+    const elemType *base = items.data();
+    size_t k[groupSize];
+    size_t first, groupCount, i;
+    bool active;
+
+    for (first = 0; first < n; first += groupSize)
+    {
+        groupCount = (n - first < groupSize) ? n - first : groupSize;
+        for (i = 0; i < groupCount; i++)
+            k[i] = 1;
+
+        active = (count > 0);
+        while (active)
+        {
+            active = false;
+            for (i = 0; i < groupCount; i++)
+            {
+                if (k[i] <= count)
+                {
+#if defined(__GNUC__)
+                    __builtin_prefetch(base + 16 * k[i]);
+#endif
+                    k[i] = 2 * k[i] + comp(base[k[i]], keys[first + i]);
+                    active = true;
+                }
+            }
+        }
+
+        for (i = 0; i < groupCount; i++)
+        {
+            size_t j = finish(k[i]);
+            out[first + i] = (j != 0 && j <= count && !comp(keys[first + i], base[j]));
+        }
+    }
+} //end scalarBatch
+
+#ifdef EYTZINGER_AVX2
+template <class elemType, class compareType>
+__attribute__((target("avx2")))
+void eytzingerTreeType<elemType, compareType>::avx2Batch(const int* keys, size_t n, bool* out) const
+// Each group of 32 searches is kept in four vectors of eight indices.
+// Each round gathers the items at those indices, compares them with
+// the keys and moves every index that is still inside the layout one
+// level down; lanes that already reached the bottom keep their index.
+// The four gathers are independent, so their cache misses overlap,
+// and the items four levels below every lane are prefetched.
+{
+    const int *base = reinterpret_cast<const int*>(items.data());
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i limit = _mm256_set1_epi32(static_cast<int>(count + 1));
+    const __m256i last = _mm256_set1_epi32(static_cast<int>(count));
+    __m256i key[4], index[4], active[4];
+    alignas(32) unsigned int k[32];
+    size_t first = 0, i, v;
+    bool running;
+
+    for (; first + 32 <= n; first += 32)
+    {
+        for (v = 0; v < 4; v++)
+        {
+            key[v] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + first + 8 * v));
+            index[v] = one;
+            active[v] = _mm256_cmpgt_epi32(limit, index[v]);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(k + 8 * v), index[v]);
+        }
+
+        running = (count > 0);
+        while (running)
+        {
+            running = false;
+            for (v = 0; v < 4; v++)
+            {
+                __m256i item = _mm256_i32gather_epi32(base, _mm256_min_epu32(index[v], last), 4);
+                __m256i greater = _mm256_cmpgt_epi32(key[v], item);
+                __m256i next = _mm256_sub_epi32(_mm256_add_epi32(index[v], index[v]), greater);
+                index[v] = _mm256_blendv_epi8(index[v], next, active[v]);
+                active[v] = _mm256_cmpgt_epi32(limit, index[v]);
+                _mm256_store_si256(reinterpret_cast<__m256i*>(k + 8 * v), index[v]);
+                running = running || !_mm256_testz_si256(active[v], active[v]);
+            }
+            for (i = 0; i < 32; i++)
+                __builtin_prefetch(base + 16 * size_t(k[i]));
+        }
+
+        for (i = 0; i < 32; i++)
+        {
+            size_t j = finish(k[i]);
+            out[first + i] = (j != 0 && base[j] == keys[first + i]);
+        }
+    }
+    scalarBatch(reinterpret_cast<const elemType*>(keys) + first, n - first, out + first);
+} //end avx2Batch
+
+template <class elemType, class compareType>
+__attribute__((target("avx2")))
+void eytzingerTreeType<elemType, compareType>::avx2Batch(const long long* keys, size_t n, bool* out) const
+// Same as the int version with four 64-bit items per vector; the
+// indices stay 64-bit so they can be doubled without overflow.
+{
+    const long long *base = reinterpret_cast<const long long*>(items.data());
+    const __m256i one = _mm256_set1_epi64x(1);
+    const __m256i limit = _mm256_set1_epi64x(static_cast<long long>(count + 1));
+    const __m256i last = _mm256_set1_epi64x(static_cast<long long>(count));
+    alignas(32) unsigned long long k[4];
+    size_t first = 0, i;
+
+    for (; first + 4 <= n; first += 4)
+    {
+        __m256i key = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + first));
+        __m256i index = one;
+        __m256i active = _mm256_cmpgt_epi64(limit, index);
+
+        while (!_mm256_testz_si256(active, active))
+        {
+            __m256i clamped = _mm256_blendv_epi8(last, index, active);
+            __m256i item = _mm256_i64gather_epi64(base, clamped, 8);
+            __m256i greater = _mm256_cmpgt_epi64(key, item);
+            __m256i next = _mm256_sub_epi64(_mm256_add_epi64(index, index), greater);
+            index = _mm256_blendv_epi8(index, next, active);
+            active = _mm256_cmpgt_epi64(limit, index);
+        }
+
+        _mm256_store_si256(reinterpret_cast<__m256i*>(k), index);
+        for (i = 0; i < 4; i++)
+        {
+            size_t j = finish(k[i]);
+            out[first + i] = (j != 0 && base[j] == keys[first + i]);
+        }
+    }
+    scalarBatch(reinterpret_cast<const elemType*>(keys) + first, n - first, out + first);
+} //end avx2Batch
+#endif
+
+#endif
@@ -0,0 +1,533 @@
+#ifndef LAZYDELETETREETYPE_H
+#define LAZYDELETETREETYPE_H
+
+/* A binary search tree whose deletes only mark the node of the item
+   as a tombstone, in the time of a search; nothing is unlinked or
+   restructured. search, treeNodeCount and inorderTraversal skip the
+   tombstones, and an insert of an item whose node is a tombstone
+   takes the node back.
+   The tombstones are removed by compaction, which sweeps the tree in
+   inorder sequence a bounded piece at a time: each compactStep
+   rebuilds one subtree of at most stepNodes nodes into a perfectly
+   balanced subtree of its live nodes, or removes one tombstone from a
+   node above such subtrees, so a call takes O(height + stepNodes)
+   time. deleteNode runs one step itself whenever the tombstones are
+   more than maxRatio of the nodes; compactStep can also be called
+   directly, e.g. when the program is idle.
+   Every node holds a lazyEntry, the item with its tombstone flag. The
+   tree is derived from bSearchTreeType as protected: only the
+   functions declared here and the read-only ones made public with
+   using are available, so nothing else changes the nodes behind the
+   count of tombstones.
+*/
+
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "bSearchTreeType.h"
+
+using namespace std;
+
+// Definition of the item stored in the nodes of the tree
+template <class elemType>
+struct lazyEntry
+{
+    elemType item;
+    bool deleted;                       // The item is a tombstone
+
+    template <class itemArg,
+              class = typename enable_if<!is_same<typename decay<itemArg>::type,
+                                                  lazyEntry>::value>::type>
+    explicit lazyEntry(itemArg&& x) : item(std::forward<itemArg>(x)), deleted(false) {}
+
+    lazyEntry() : item(), deleted(false) {}
+};
+
+// Order of the entries by their items. It is transparent, so the tree
+// can be searched with an item instead of a whole entry.
+template <class elemType, class compareType>
+struct lazyEntryCompare
+{
+    typedef void is_transparent;
+
+    compareType itemComp;
+
+    template <class leftType, class rightType>
+    bool operator()(const leftType& a, const rightType& b) const
+    {
+        return itemComp(itemOf(a), itemOf(b));
+    }
+
+    template <class leftType, class rightType>
+    int compare(const leftType& a, const rightType& b) const
+    {
+        return treeCompare(itemComp, itemOf(a), itemOf(b));
+    }
+
+    static const elemType& itemOf(const lazyEntry<elemType>& entry)
+    {
+        return entry.item;
+    }
+
+    template <class otherType>
+    static const otherType& itemOf(const otherType& item)
+    {
+        return item;
+    }
+
+    lazyEntryCompare() {}
+    explicit lazyEntryCompare(const compareType& compare) : itemComp(compare) {}
+};
+
+template <class elemType, class allocType = nodeAllocator<lazyEntry<elemType> >,
+          class compareType = less<elemType> >
+class lazyDeleteTreeType: protected bSearchTreeType<lazyEntry<elemType>, allocType,
+                                                    lazyEntryCompare<elemType, compareType> >
+{
+    typedef bSearchTreeType<lazyEntry<elemType>, allocType,
+                            lazyEntryCompare<elemType, compareType> > baseType;
+
+public:
+    typedef lazyEntry<elemType> entryType;
+
+    using baseType::isEmpty;
+    using baseType::treeHeight;
+    using baseType::treeLeavesCount;
+    using baseType::shapeReport;
+#ifdef BINARYTREE_STATS
+    using baseType::statistics;
+    using baseType::resetStatistics;
+    using baseType::writeStatistics;
+#endif
+    //The functions of binaryTreeType that only read the tree;
+    //treeHeight, treeLeavesCount and shapeReport count the
+    //tombstones as nodes.
+
+    bool search(const elemType& searchItem) const;
+    //Function to determine if searchItem is in the tree.
+    //Postcondition: Returns true if searchItem is found and its
+    // node is not a tombstone; otherwise, returns
+    // false. Searching an empty tree reports the
+    // searchEmptyTree event.
+
+    bool insert(const elemType& insertItem);
+    bool insert(elemType&& insertItem);
+    //Function to insert insertItem in the tree.
+    //Postcondition: If insertItem is not in the tree, it is
+    // stored in its tombstone node if there is one,
+    // or in a new node, and true is returned;
+    // otherwise, insertDuplicate is reported and
+    // false is returned.
+
+    bool deleteNode(const elemType& deleteItem);
+    //Function to delete deleteItem from the tree.
+    //Postcondition: If deleteItem is found, its node becomes a
+    // tombstone and true is returned; if the
+    // tombstones are then more than maxRatio of the
+    // nodes, one compactStep of stepNodes is run.
+    // Otherwise, deleteEmptyTree or deleteNotFound
+    // is reported and false is returned.
+
+    template <class visitor>
+    void inorderTraversal(visitor&& visit);
+    template <class visitor>
+    void inorderTraversal(visitor&& visit) const;
+    //Function to visit the items that are not tombstones in
+    //inorder sequence; the const version calls visit with a
+    //const elemType&.
+
+    int treeNodeCount() const;
+    //Postcondition: Returns the number of items in the tree,
+    // not counting the tombstones.
+
+    int tombstoneCount() const;
+    //Postcondition: Returns the number of tombstones.
+
+    void setCompaction(double maxRatio, int stepNodes);
+    //Function to set when deleteNode compacts the tree and how
+    //much work it does then (0.25 and 16 by default). A
+    //maxRatio of 1 or more turns the compaction by deleteNode
+    //off.
+    //Postcondition: deleteNode runs compactStep(stepNodes) when
+    // the tombstones are more than maxRatio of the
+    // nodes.
+
+    int compactStep(int maxNodes);
+    //Function to do one step of the compaction, continuing the
+    //sweep where the last step left it. Takes O(height +
+    //maxNodes) time.
+    //Postcondition: The next subtree of at most maxNodes nodes
+    // is rebuilt from its live nodes, or, if the next
+    // node has a larger subtree, that node is removed
+    // if it is a tombstone. Returns the number of
+    // tombstones removed.
+
+    int compact();
+    //Function to remove every tombstone, rebuilding the whole
+    //tree in O(n) time.
+    //Postcondition: The tree is perfectly balanced and has no
+    // tombstones; returns the number removed.
+
+    void destroyTree();
+    //Postcondition: The tree is empty and the nodes are freed.
+
+    lazyDeleteTreeType(const lazyDeleteTreeType<elemType, allocType, compareType>& otherTree);
+    lazyDeleteTreeType(lazyDeleteTreeType<elemType, allocType, compareType>&& otherTree);
+    lazyDeleteTreeType<elemType, allocType, compareType>& operator=
+                (const lazyDeleteTreeType<elemType, allocType, compareType>& otherTree);
+    lazyDeleteTreeType<elemType, allocType, compareType>& operator=
+                (lazyDeleteTreeType<elemType, allocType, compareType>&& otherTree);
+    //Copy and move; the tombstones are copied or moved with the
+    //nodes. A moved-from tree is empty.
+
+    template <class inputIterator>
+    lazyDeleteTreeType(inputIterator first, inputIterator last,
+                       const compareType& compare = compareType());
+    //Constructor that builds the tree from the items in
+    //[first, last) with buildTree.
+
+    explicit lazyDeleteTreeType(const compareType& compare);
+    //Constructor of an empty tree ordered by compare.
+
+    lazyDeleteTreeType();
+    //Default constructor
+
+private:
+    template <class itemType>
+    bool insertItem(itemType&& item);
+    //Function to do insert for a copied or moved item.
+
+    nodeType<entryType>* rebuildLive(nodeType<entryType> *p, int& removed);
+    //Function to relink the live nodes of the tree to which p
+    //points into a perfectly balanced tree.
+    //Postcondition: Returns its root; the tombstones are
+    // deallocated and removed is their number.
+
+    int tombstones;                     // Number of tombstones
+    int cursor;                         // Rank of the next node of the sweep
+    double maxRatio;                    // Tombstone ratio that triggers a step
+    int stepNodes;                      // Subtree size of a step of deleteNode
+};
+
+template <class elemType, class allocType, class compareType>
+lazyDeleteTreeType<elemType, allocType, compareType>::lazyDeleteTreeType()
+    : tombstones(0), cursor(0), maxRatio(0.25), stepNodes(16)
+{
+}
+
+template <class elemType, class allocType, class compareType>
+lazyDeleteTreeType<elemType, allocType, compareType>::lazyDeleteTreeType(const compareType& compare)
+    : baseType(lazyEntryCompare<elemType, compareType>(compare)),
+      tombstones(0), cursor(0), maxRatio(0.25), stepNodes(16)
+{
+}
+
+template <class elemType, class allocType, class compareType>
+template <class inputIterator>
+lazyDeleteTreeType<elemType, allocType, compareType>::lazyDeleteTreeType
+                (inputIterator first, inputIterator last, const compareType& compare)
+    : baseType(first, last, lazyEntryCompare<elemType, compareType>(compare)),
+      tombstones(0), cursor(0), maxRatio(0.25), stepNodes(16)
+{
+}
+
+template <class elemType, class allocType, class compareType>
+lazyDeleteTreeType<elemType, allocType, compareType>::lazyDeleteTreeType
+                (const lazyDeleteTreeType<elemType, allocType, compareType>& otherTree)
+    : baseType(otherTree), tombstones(otherTree.tombstones), cursor(otherTree.cursor),
+      maxRatio(otherTree.maxRatio), stepNodes(otherTree.stepNodes)
+{
+}
+
+template <class elemType, class allocType, class compareType>
+lazyDeleteTreeType<elemType, allocType, compareType>::lazyDeleteTreeType
+                (lazyDeleteTreeType<elemType, allocType, compareType>&& otherTree)
+    : baseType(std::move(otherTree)), tombstones(otherTree.tombstones), cursor(otherTree.cursor),
+      maxRatio(otherTree.maxRatio), stepNodes(otherTree.stepNodes)
+{
+    otherTree.tombstones = 0;
+    otherTree.cursor = 0;
+}
+
+template <class elemType, class allocType, class compareType>
+lazyDeleteTreeType<elemType, allocType, compareType>& lazyDeleteTreeType<elemType, allocType, compareType>::operator=
+                (const lazyDeleteTreeType<elemType, allocType, compareType>& otherTree)
+{
+    if (this != &otherTree)
+    {
+        baseType::operator=(otherTree);
+        tombstones = otherTree.tombstones;
+        cursor = otherTree.cursor;
+        maxRatio = otherTree.maxRatio;
+        stepNodes = otherTree.stepNodes;
+    }
+    return *this;
+} //end copy assignment
+
+template <class elemType, class allocType, class compareType>
+lazyDeleteTreeType<elemType, allocType, compareType>& lazyDeleteTreeType<elemType, allocType, compareType>::operator=
+                (lazyDeleteTreeType<elemType, allocType, compareType>&& otherTree)
+{
+    if (this != &otherTree)
+    {
+        baseType::operator=(std::move(otherTree));
+        tombstones = otherTree.tombstones;
+        cursor = otherTree.cursor;
+        maxRatio = otherTree.maxRatio;
+        stepNodes = otherTree.stepNodes;
+        otherTree.tombstones = 0;
+        otherTree.cursor = 0;
+    }
+    return *this;
+} //end move assignment
+
+template <class elemType, class allocType, class compareType>
+int lazyDeleteTreeType<elemType, allocType, compareType>::treeNodeCount() const
+{
+    return this->nodeCount(this->root) - tombstones;
+}
+
+template <class elemType, class allocType, class compareType>
+int lazyDeleteTreeType<elemType, allocType, compareType>::tombstoneCount() const
+{
+    return tombstones;
+}
+
+template <class elemType, class allocType, class compareType>
+void lazyDeleteTreeType<elemType, allocType, compareType>::setCompaction(double maxRatio, int stepNodes)
+{
+    this->maxRatio = maxRatio;
+    this->stepNodes = (stepNodes > 0 ? stepNodes : 1);
+}
+
+template <class elemType, class allocType, class compareType>
+void lazyDeleteTreeType<elemType, allocType, compareType>::destroyTree()
+{
+    baseType::destroyTree();
+    tombstones = 0;
+    cursor = 0;
+}
+
+template <class elemType, class allocType, class compareType>
+bool lazyDeleteTreeType<elemType, allocType, compareType>::search(const elemType& searchItem) const
+{
+    nodeType<entryType> *current = this->root;
+    int order;
+    TREE_STATS_BEGIN();
+    if (this->root == nullptr)
+        reportTreeEvent(searchEmptyTree);
+    while (current != nullptr)
+    {
+        TREE_STATS_VISIT();
+        order = this->compareItems(current->info, searchItem);
+        if (order == 0)
+            break;
+        else if (order > 0)
+            current = current->lLink;
+        else
+            current = current->rLink;
+    }
+    bool found = (current != nullptr && !current->info.deleted);
+    TREE_STATS_END(searchOperation, found);
+    return found;
+} //end search
+
+template <class elemType, class allocType, class compareType>
+bool lazyDeleteTreeType<elemType, allocType, compareType>::insert(const elemType& insertItem)
+{
+    return this->insertItem(insertItem);
+}
+
+template <class elemType, class allocType, class compareType>
+bool lazyDeleteTreeType<elemType, allocType, compareType>::insert(elemType&& insertItem)
+{
+    return this->insertItem(std::move(insertItem));
+}
+
+template <class elemType, class allocType, class compareType>
+template <class itemType>
+bool lazyDeleteTreeType<elemType, allocType, compareType>::insertItem(itemType&& item)
+{
+    nodeType<entryType> *path[baseType::maxPath];
+    int depth;
+    TREE_STATS_BEGIN();
+    nodeType<entryType>* *link = this->findPath(item, path, depth);
+    bool inserted = true;
+
+    if (*link == nullptr)
+    {
+        *link = this->alloc.allocate(std::forward<itemType>(item));
+        this->updatePath(path, depth, (*link)->info.item, 1);
+    }
+    else if ((*link)->info.deleted)
+    {
+        (*link)->info.item = std::forward<itemType>(item);
+        (*link)->info.deleted = false;
+        tombstones--;
+    }
+    else
+    {
+        reportTreeEvent(insertDuplicate);
+        inserted = false;
+    }
+    TREE_STATS_END(insertOperation, inserted);
+    return inserted;
+} //end insertItem
+
+template <class elemType, class allocType, class compareType>
+bool lazyDeleteTreeType<elemType, allocType, compareType>::deleteNode(const elemType& deleteItem)
+{
+    bool deleted = false;
+    TREE_STATS_BEGIN();
+    if (this->root == nullptr)
+        reportTreeEvent(deleteEmptyTree);
+    else
+    {
+        nodeType<entryType>* *link = this->findLink(deleteItem);
+
+        if (*link != nullptr && !(*link)->info.deleted)
+        {
+            (*link)->info.deleted = true;
+            tombstones++;
+            deleted = true;
+        }
+        else
+            reportTreeEvent(deleteNotFound);
+    }
+    TREE_STATS_END(deleteOperation, deleted);
+
+    if (deleted && tombstones > maxRatio * this->nodeCount(this->root))
+        compactStep(stepNodes);
+    return deleted;
+} //end deleteNode
+
+template <class elemType, class allocType, class compareType>
+template <class visitor>
+void lazyDeleteTreeType<elemType, allocType, compareType>::inorderTraversal(visitor&& visit)
+{
+    baseType::inorderTraversal([&visit](entryType& entry)
+    {
+        if (!entry.deleted)
+            visit(entry.item);
+    });
+} //end inorderTraversal
+
+template <class elemType, class allocType, class compareType>
+template <class visitor>
+void lazyDeleteTreeType<elemType, allocType, compareType>::inorderTraversal(visitor&& visit) const
+{
+    baseType::inorderTraversal([&visit](const entryType& entry)
+    {
+        if (!entry.deleted)
+            visit(static_cast<const elemType&>(entry.item));
+    });
+} //end inorderTraversal
+
+template <class elemType, class allocType, class compareType>
+nodeType<lazyEntry<elemType> >* lazyDeleteTreeType<elemType, allocType, compareType>::rebuildLive
+                (nodeType<entryType> *p, int& removed)
+{
+    vector<nodeType<entryType>*> nodes;
+    size_t live = 0;
+
+    this->inorderNodes(p, nodes);
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        if (nodes[i]->info.deleted)
+            this->alloc.deallocate(nodes[i]);
+        else
+            nodes[live++] = nodes[i];
+    }
+    removed = static_cast<int>(nodes.size() - live);
+    return this->linkBalanced(nodes, 0, live);
+} //end rebuildLive
+
+template <class elemType, class allocType, class compareType>
+int lazyDeleteTreeType<elemType, allocType, compareType>::compactStep(int maxNodes)
+// The sweep position is a rank, so it stays meaningful while the tree
+// changes between steps. The descent goes towards that rank until the
+// subtree is small enough; a larger node met exactly at the rank is
+// handled on its own, by taking the item of its successor if it has
+// two children.
+{
+    nodeType<entryType>* *link = &this->root;
+    vector<nodeType<entryType>*> path;
+    int rank, removed = 0;
+
+    if (tombstones == 0 || this->root == nullptr)
+        return 0;
+    if (maxNodes < 1)
+        maxNodes = 1;
+    if (cursor >= this->nodeCount(this->root))
+        cursor = 0;
+    rank = cursor;
+
+    while ((*link)->size > maxNodes)
+    {
+        nodeType<entryType> *p = *link;
+        int leftSize = this->nodeCount(p->lLink);
+
+        path.push_back(p);
+        if (rank < leftSize)
+            link = &p->lLink;
+        else if (rank > leftSize)
+        {
+            rank -= leftSize + 1;
+            link = &p->rLink;
+        }
+        else
+        {
+            if (!p->info.deleted)
+            {
+                cursor++;
+                return 0;
+            }
+            for (size_t i = 0; i < path.size(); i++)
+                path[i]->size--;
+            if (p->lLink == nullptr || p->rLink == nullptr)
+            {
+                *link = (p->lLink == nullptr) ? p->rLink : p->lLink;
+                this->alloc.deallocate(p);
+            }
+            else
+            {
+                nodeType<entryType>* *next = &p->rLink;
+                nodeType<entryType> *successor;
+
+                while ((*next)->lLink != nullptr)
+                {
+                    (*next)->size--;
+                    next = &(*next)->lLink;
+                }
+                successor = *next;
+                *next = successor->rLink;
+                p->info = std::move(successor->info);
+                this->alloc.deallocate(successor);
+            }
+            tombstones--;
+            return 1;
+        }
+    }
+
+    int before = (*link)->size;
+
+    *link = rebuildLive(*link, removed);
+    for (size_t i = 0; i < path.size(); i++)
+        path[i]->size -= removed;
+    tombstones -= removed;
+    cursor += before - removed - rank;
+    return removed;
+} //end compactStep
+
+template <class elemType, class allocType, class compareType>
+int lazyDeleteTreeType<elemType, allocType, compareType>::compact()
+{
+    int removed = 0;
+
+    this->root = rebuildLive(this->root, removed);
+    tombstones = 0;
+    cursor = 0;
+    return removed;
+} //end compact
+
+#endif
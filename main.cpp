@@ -1,53 +1,88 @@
 #include <iostream>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include "binaryTreeType.h"
 #include "bSearchTreeType.h"
+#include "numberReader.h"
+#include "benchmark/benchmarkTimer.h"
 
 using namespace std;
 
-void print(int& x);
-void update(int& x);
-
 int main(int argc ,char* argv[])
+// Without arguments the numbers are typed in, ending with -999.
+// With a file name (or - for standard input) the numbers are read
+// from the file up to its end or the first -999, and the time taken
+// is reported instead of the nodes.
 {
     bSearchTreeType<int> treeRoot;
 
     int num;
+    long long sum = 0;
+    vector<int> numbers;
+    bool fromFile = (argc > 1);
+
+    if (fromFile)
+    {
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        bool success;
+
+        if (strcmp(argv[1], "-") == 0)
+            success = readNumbers(stdin, numbers);
+        else
+            success = readNumbers(argv[1], numbers);
+        if (!success)
+        {
+            cout << "Cannot read the numbers of " << argv[1] << endl;
+            return 1;
+        }
+        numbers.erase(find(numbers.begin(), numbers.end(), -999), numbers.end());
+        double readTime = secondsSince(start);
 
-    cout << "Enter numers ending "
-         << "with -999. " << endl;
-    cin >> num;
+        start = chrono::steady_clock::now();
+        treeRoot.buildTree(numbers.begin(), numbers.end());
+        double buildTime = secondsSince(start);
 
-    while (num != -999)
+        cout << "Read " << numbers.size() << " numbers in " << readTime << " s ("
+             << (readTime > 0 ? numbers.size() / readTime : 0) << " numbers/sec)" << endl
+             << "Built a tree of " << treeRoot.treeNodeCount() << " nodes in "
+             << buildTime << " s ("
+             << (buildTime > 0 ? numbers.size() / buildTime : 0) << " numbers/sec)" << endl;
+    }
+    else
     {
-        treeRoot.insert(num);
+        cout << "Enter numers ending "
+             << "with -999. " << endl;
         cin >> num;
-    }
 
-    cout << endl
-         << "Tree nodes in inorder: ";
-    treeRoot.inorderTraversal(print);
+        while (num != -999)
+        {
+            numbers.push_back(num);
+            cin >> num;
+        }
+        treeRoot.buildTree(numbers.begin(), numbers.end());
+
+        cout << endl
+             << "Tree nodes in inorder: ";
+        treeRoot.inorderTraversal([](int& x) { cout << x << " "; });
+    }
     cout << endl << "Tree height: "
          << treeRoot.treeHeight()
          << endl << endl;
 
     cout << "***************** Update nodes ************" << endl;
-    treeRoot.inorderTraversal(update);
-    cout << "Tree nodes in inorder "
-         << "after the update: " << endl
-         << "       ";
-    treeRoot.inorderTraversal(print);
-    cout << endl << "Tree Height: "
+    treeRoot.inorderTraversal([&sum](int& x) { x = 2 * x; sum += x; });
+    if (!fromFile)
+    {
+        cout << "Tree nodes in inorder "
+             << "after the update: " << endl
+             << "       ";
+        treeRoot.inorderTraversal([](int& x) { cout << x << " "; });
+    }
+    cout << endl << "Sum of the nodes: " << sum
+         << endl << "Tree Height: "
          << treeRoot.treeHeight() << endl;
 
     return 0;
 }
-
-void print(int& x)
-{
-    cout << x << " ";
-}
-
-void update(int& x)
-{
-    x = 2 * x;
-}
\ No newline at end of file
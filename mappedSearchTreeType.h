@@ -0,0 +1,272 @@
+#ifndef MAPPEDSEARCHTREETYPE_H
+#define MAPPEDSEARCHTREETYPE_H
+
+/* Read-only search over a file written by bSearchTreeType::saveTree,
+   without loading it. The file is mapped into memory and search runs
+   a binary search directly on the sorted items in the mapped pages,
+   so opening a file of any size takes constant time, no nodeType is
+   created, and only the pages a search touches are read from disk.
+   Several processes searching the same file share its pages.
+   open checks the header and the file size; the checksum is only
+   checked by verify, which has to read the whole file.
+   compareType must be the order of the tree that saved the file (the
+   order its items are in); verify also checks that order.
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include "treeCompare.h"
+#include "treeDiagnostics.h"
+#include "treeFileFormat.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+template <class elemType, class compareType = less<elemType> >
+class mappedSearchTreeType
+{
+    static_assert(is_trivially_copyable<elemType>::value,
+                  "mappedSearchTreeType needs a trivially copyable elemType");
+
+public:
+    bool open(const char* fileName);
+    //Function to map the file fileName written by saveTree.
+    //Postcondition: Returns true if the file was mapped and its
+    // header and size match elemType; otherwise,
+    // returns false and no file is mapped. A file
+    // that was mapped before is closed first.
+
+    void close();
+    //Postcondition: The file is unmapped; the tree is empty.
+
+    bool verify() const;
+    //Function to check the items against the checksum in the
+    //header and their order against compareType. Reads every
+    //page of the file.
+    //Postcondition: Returns true if the checksum matches and
+    // the items are in strictly increasing order.
+
+    bool search(const elemType& searchItem) const;
+    //Function to determine if searchItem is in the file.
+    //Postcondition: Returns true if searchItem is found;
+    // otherwise, returns false. Searching an empty
+    // tree reports the searchEmptyTree event.
+
+    bool isEmpty() const;
+    //Postcondition: Returns true if no items are mapped.
+
+    size_t treeNodeCount() const;
+    //Postcondition: Returns the number of items in the file.
+
+    mappedSearchTreeType();
+    //Default constructor
+
+    explicit mappedSearchTreeType(const char* fileName,
+                                  const compareType& compare = compareType());
+    //Constructor that maps fileName with open; the items are
+    //searched in the order compare.
+
+    ~mappedSearchTreeType();
+    //Destructor
+
+    mappedSearchTreeType(const mappedSearchTreeType<elemType, compareType>&) = delete;
+    const mappedSearchTreeType<elemType, compareType>& operator=
+                (const mappedSearchTreeType<elemType, compareType>&) = delete;
+
+private:
+    const elemType *items;          // First item in the mapping
+    size_t count;                   // Number of items
+    uint64_t checksum;              // Checksum from the header
+    void *mapping;                  // Start of the mapping, nullptr if none
+    size_t mappedBytes;             // Length of the mapping
+    compareType comp;               // Order of the items
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE fileMapping;
+#endif
+};
+
+template <class elemType, class compareType>
+mappedSearchTreeType<elemType, compareType>::mappedSearchTreeType()
+{
+    items = nullptr;
+    count = 0;
+    checksum = 0;
+    mapping = nullptr;
+    mappedBytes = 0;
+#ifdef _WIN32
+    file = INVALID_HANDLE_VALUE;
+    fileMapping = nullptr;
+#endif
+}
+
+template <class elemType, class compareType>
+mappedSearchTreeType<elemType, compareType>::mappedSearchTreeType
+                (const char* fileName, const compareType& compare)
+    : mappedSearchTreeType()
+{
+    comp = compare;
+    open(fileName);
+}
+
+template <class elemType, class compareType>
+mappedSearchTreeType<elemType, compareType>::~mappedSearchTreeType()
+{
+    close();
+}
+
+template <class elemType, class compareType>
+bool mappedSearchTreeType<elemType, compareType>::open(const char* fileName)
+{
+    treeFileHeader header;
+
+    close();
+
+#ifdef _WIN32
+    LARGE_INTEGER fileSize;
+
+    file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                       FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < (LONGLONG)sizeof(header))
+    {
+        close();
+        return false;
+    }
+    mappedBytes = static_cast<size_t>(fileSize.QuadPart);
+    fileMapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (fileMapping != nullptr)
+        mapping = MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0);
+#else
+    struct stat fileStatus;
+    int fd = ::open(fileName, O_RDONLY);
+
+    if (fd < 0)
+        return false;
+    if (fstat(fd, &fileStatus) != 0 || fileStatus.st_size < (off_t)sizeof(header))
+    {
+        ::close(fd);
+        return false;
+    }
+    mappedBytes = static_cast<size_t>(fileStatus.st_size);
+    mapping = mmap(nullptr, mappedBytes, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);                    // the mapping keeps the file open
+    if (mapping == MAP_FAILED)
+        mapping = nullptr;
+    else
+        madvise(mapping, mappedBytes, MADV_RANDOM);
+#endif
+
+    if (mapping == nullptr)
+    {
+        close();
+        return false;
+    }
+
+    memcpy(&header, mapping, sizeof(header));
+    if (!validTreeHeader(header, sizeof(elemType))
+        || header.count > (mappedBytes - sizeof(header)) / sizeof(elemType))
+    {
+        close();
+        return false;
+    }
+
+    items = reinterpret_cast<const elemType*>(static_cast<const char*>(mapping) + sizeof(header));
+    count = static_cast<size_t>(header.count);
+    checksum = header.checksum;
+    return true;
+} //end open
+
+template <class elemType, class compareType>
+void mappedSearchTreeType<elemType, compareType>::close()
+{
+#ifdef _WIN32
+    if (mapping != nullptr)
+        UnmapViewOfFile(mapping);
+    if (fileMapping != nullptr)
+        CloseHandle(fileMapping);
+    if (file != INVALID_HANDLE_VALUE)
+        CloseHandle(file);
+    fileMapping = nullptr;
+    file = INVALID_HANDLE_VALUE;
+#else
+    if (mapping != nullptr)
+        munmap(mapping, mappedBytes);
+#endif
+    items = nullptr;
+    count = 0;
+    checksum = 0;
+    mapping = nullptr;
+    mappedBytes = 0;
+}
+
+template <class elemType, class compareType>
+bool mappedSearchTreeType<elemType, compareType>::verify() const
+{
+    if (mapping == nullptr || treeChecksum(items, count * sizeof(elemType)) != checksum)
+        return false;
+    for (size_t i = 1; i < count; i++)
+        if (!comp(items[i - 1], items[i]))
+            return false;
+    return true;
+}
+
+template <class elemType, class compareType>
+bool mappedSearchTreeType<elemType, compareType>::isEmpty() const
+{
+    return (count == 0);
+}
+
+template <class elemType, class compareType>
+size_t mappedSearchTreeType<elemType, compareType>::treeNodeCount() const
+{
+    return count;
+}
+
+template <class elemType, class compareType>
+bool mappedSearchTreeType<elemType, compareType>::search(const elemType& searchItem) const
+// Each step halves the range [base, base + n) that holds the largest
+// item not greater than searchItem; the next position is chosen with
+// a conditional move rather than a branch, and the two items that the
+// next step may compare are prefetched.
+{
+    const elemType *base = items;
+    size_t n = count;
+
+    if (n == 0)
+    {
+        reportTreeEvent(searchEmptyTree);
+        return false;
+    }
+
+    while (n > 1)
+    {
+        size_t half = n / 2;
+#if defined(__GNUC__)
+        __builtin_prefetch(base + half / 2);
+        __builtin_prefetch(base + half + half / 2);
+#endif
+        base = comp(searchItem, base[half]) ? base : base + half;
+        n -= half;
+    }
+    return (treeCompare(comp, *base, searchItem) == 0);
+} //end search
+
+#endif
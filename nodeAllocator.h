@@ -0,0 +1,276 @@
+// Node allocators for binaryTreeType and the trees derived from it.
+// A tree owns one allocator object and gets every node from it:
+//      allocate(args...)   returns a new node whose info is
+//                          constructed in place from args, with
+//                          no children, height 1 and size 1
+//      deallocate(p)       destroys and releases the node p
+//      reserve(n)          hint that n more nodes are about to be
+//                          allocated
+//      releaseAll()        releases every node handed out, without
+//                          calling their destructors; only available
+//                          when bulkRelease is true
+// With BINARYTREE_STATS defined, an allocator also counts its nodes
+// (allocationCount, deallocationCount; see treeStatistics.h).
+// threadSafe tells whether allocate and deallocate may be called from
+// several threads at once, which the parallel copy and destroy of
+// binaryTreeType need.
+#ifndef NODEALLOCATOR_H
+#define NODEALLOCATOR_H
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+#include "treeStatistics.h"
+
+using namespace std;
+
+template <class elemType>
+struct nodeType;
+
+// Default allocator: every node is a separate new/delete.
+template <class elemType>
+class nodeAllocator
+{
+public:
+    static const bool bulkRelease = false;
+    static const bool threadSafe = true;
+
+    template <class... argTypes>
+    nodeType<elemType>* allocate(argTypes&&... args);
+    //Postcondition: Returns a pointer to a node created with new.
+
+    void deallocate(nodeType<elemType> *p);
+    //Postcondition: The node to which p points is deleted.
+
+    void reserve(size_t) {}
+    void releaseAll() {}
+
+#ifdef BINARYTREE_STATS
+    allocationCounter counter;          // Nodes allocated and deallocated
+#endif
+};
+
+template <class elemType>
+template <class... argTypes>
+nodeType<elemType>* nodeAllocator<elemType>::allocate(argTypes&&... args)
+{
+#ifdef BINARYTREE_STATS
+    counter.allocated();
+#endif
+    return new nodeType<elemType>{elemType(std::forward<argTypes>(args)...), nullptr, nullptr, 1, 1};
+}
+
+template <class elemType>
+void nodeAllocator<elemType>::deallocate(nodeType<elemType> *p)
+{
+#ifdef BINARYTREE_STATS
+    counter.deallocated();
+#endif
+    delete p;
+}
+
+// Pool allocator: nodes are carved out of contiguous blocks of
+// blockSize nodes; deallocated nodes go on a free list and are
+// handed out again before the next block is touched. releaseAll
+// gives every block back in O(number of blocks).
+template <class elemType, size_t blockSize = 1024>
+class nodePoolAllocator
+{
+public:
+    static const bool bulkRelease = true;
+    static const bool threadSafe = false;
+
+    template <class... argTypes>
+    nodeType<elemType>* allocate(argTypes&&... args);
+    //Postcondition: Returns a pointer to a node taken from the
+    // free list, or from the current block if the
+    // free list is empty.
+
+    void deallocate(nodeType<elemType> *p);
+    //Postcondition: The node to which p points is destroyed and
+    // put on the free list.
+
+    void reserve(size_t n);
+    //Function to make sure the next n allocations start no
+    //block of their own.
+    //Postcondition: If the free list and the current block
+    // together hold fewer than n nodes, the rest of
+    // the current block is put on the free list and
+    // a new block of at least the missing nodes is
+    // started.
+
+    void releaseAll();
+    //Postcondition: Every block is released; nodes handed out
+    // before the call must not be used again.
+
+    nodePoolAllocator();
+    nodePoolAllocator(const nodePoolAllocator<elemType, blockSize>&) = delete;
+    const nodePoolAllocator<elemType, blockSize>& operator=
+                (const nodePoolAllocator<elemType, blockSize>&) = delete;
+    nodePoolAllocator(nodePoolAllocator<elemType, blockSize>&& otherPool);
+    nodePoolAllocator<elemType, blockSize>& operator=
+                (nodePoolAllocator<elemType, blockSize>&& otherPool);
+    //Moving a pool hands over its blocks; otherPool is left
+    //empty.
+    ~nodePoolAllocator();
+
+#ifdef BINARYTREE_STATS
+    allocationCounter counter;          // Nodes allocated and deallocated
+#endif
+
+private:
+    struct freeSlot
+    {
+        freeSlot *next;
+    };
+
+    void newBlock(size_t n);
+    //Postcondition: A block of n nodes is allocated and becomes
+    // the current block.
+
+    vector<char*> blocks;               // Every block owned by the pool
+    char *blockNext;                    // Next unused node in the current block
+    char *blockEnd;                     // End of the current block
+    freeSlot *freeList;                 // Nodes given back by deallocate
+    size_t freeCount;                   // Number of nodes on freeList
+};
+
+template <class elemType, size_t blockSize>
+nodePoolAllocator<elemType, blockSize>::nodePoolAllocator()
+{
+    blockNext = nullptr;
+    blockEnd = nullptr;
+    freeList = nullptr;
+    freeCount = 0;
+}
+
+template <class elemType, size_t blockSize>
+nodePoolAllocator<elemType, blockSize>::nodePoolAllocator(nodePoolAllocator<elemType, blockSize>&& otherPool)
+    : blocks(std::move(otherPool.blocks))
+{
+#ifdef BINARYTREE_STATS
+    counter = otherPool.counter;
+#endif
+    blockNext = otherPool.blockNext;
+    blockEnd = otherPool.blockEnd;
+    freeList = otherPool.freeList;
+    freeCount = otherPool.freeCount;
+    otherPool.blocks.clear();
+    otherPool.blockNext = nullptr;
+    otherPool.blockEnd = nullptr;
+    otherPool.freeList = nullptr;
+    otherPool.freeCount = 0;
+}
+
+template <class elemType, size_t blockSize>
+nodePoolAllocator<elemType, blockSize>& nodePoolAllocator<elemType, blockSize>::operator=
+                (nodePoolAllocator<elemType, blockSize>&& otherPool)
+{
+    if (this != &otherPool)
+    {
+        releaseAll();
+#ifdef BINARYTREE_STATS
+        counter = otherPool.counter;
+#endif
+        blocks.swap(otherPool.blocks);
+        blockNext = otherPool.blockNext;
+        blockEnd = otherPool.blockEnd;
+        freeList = otherPool.freeList;
+        freeCount = otherPool.freeCount;
+        otherPool.blockNext = nullptr;
+        otherPool.blockEnd = nullptr;
+        otherPool.freeList = nullptr;
+        otherPool.freeCount = 0;
+    }
+    return *this;
+}
+
+template <class elemType, size_t blockSize>
+nodePoolAllocator<elemType, blockSize>::~nodePoolAllocator()
+{
+    releaseAll();
+}
+
+template <class elemType, size_t blockSize>
+void nodePoolAllocator<elemType, blockSize>::newBlock(size_t n)
+{
+    char *block = static_cast<char*>(::operator new(n * sizeof(nodeType<elemType>)));
+
+    blocks.push_back(block);
+    blockNext = block;
+    blockEnd = block + n * sizeof(nodeType<elemType>);
+}
+
+template <class elemType, size_t blockSize>
+template <class... argTypes>
+nodeType<elemType>* nodePoolAllocator<elemType, blockSize>::allocate(argTypes&&... args)
+{
+    void *slot;
+
+#ifdef BINARYTREE_STATS
+    counter.allocated();
+#endif
+    if (freeList != nullptr)
+    {
+        slot = freeList;
+        freeList = freeList->next;
+        freeCount--;
+    }
+    else
+    {
+        if (blockNext == blockEnd)
+            newBlock(blockSize);
+        slot = blockNext;
+        blockNext += sizeof(nodeType<elemType>);
+    }
+    return new (slot) nodeType<elemType>{elemType(std::forward<argTypes>(args)...), nullptr, nullptr, 1, 1};
+}
+
+template <class elemType, size_t blockSize>
+void nodePoolAllocator<elemType, blockSize>::deallocate(nodeType<elemType> *p)
+{
+#ifdef BINARYTREE_STATS
+    counter.deallocated();
+#endif
+    p->~nodeType<elemType>();
+    freeList = new (static_cast<void*>(p)) freeSlot{freeList};
+    freeCount++;
+}
+
+template <class elemType, size_t blockSize>
+void nodePoolAllocator<elemType, blockSize>::reserve(size_t n)
+{
+    size_t room = (blockEnd - blockNext) / sizeof(nodeType<elemType>);
+
+    if (freeCount + room >= n)
+        return;
+
+    // allocate takes the free list first, so keep the tail of the
+    // current block there instead of abandoning it.
+    while (blockEnd != blockNext)
+    {
+        blockEnd -= sizeof(nodeType<elemType>);
+        freeList = new (static_cast<void*>(blockEnd)) freeSlot{freeList};
+        freeCount++;
+    }
+    n -= freeCount;
+    newBlock(n > blockSize ? n : blockSize);
+}
+
+template <class elemType, size_t blockSize>
+void nodePoolAllocator<elemType, blockSize>::releaseAll()
+{
+#ifdef BINARYTREE_STATS
+    counter.releasedAll();
+#endif
+    for (size_t i = 0; i < blocks.size(); i++)
+        ::operator delete(blocks[i]);
+    blocks.clear();
+    blockNext = nullptr;
+    blockEnd = nullptr;
+    freeList = nullptr;
+    freeCount = 0;
+}
+
+#endif
@@ -0,0 +1,104 @@
+// Fast reading of whitespace-separated integers.
+// The input is read in large blocks with fread and every number is
+// converted with from_chars, which does no locale or stream state
+// handling; a number cut in two by the end of a block is moved to the
+// front of the buffer and completed by the next block. This is many
+// times faster than cin >> num for large files.
+#ifndef NUMBERREADER_H
+#define NUMBERREADER_H
+
+#include <charconv>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace std;
+
+template <class intType>
+bool readNumbers(FILE *in, vector<intType>& numbers);
+//Function to read every integer from in up to the end of the input
+//and append them to numbers.
+//Postcondition: Returns true if the whole input was read; false if
+// a read failed or a token is not an integer that
+// fits intType, in which case numbers holds the
+// values before that token.
+
+template <class intType>
+bool readNumbers(const char* fileName, vector<intType>& numbers);
+//Function to read every integer of the file fileName.
+//Postcondition: Same as above; false if the file cannot be opened.
+
+inline bool isNumberSpace(char c)
+{
+    return (c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f');
+}
+
+template <class intType>
+bool readNumbers(FILE *in, vector<intType>& numbers)
+{
+    const size_t blockSize = 1 << 20;
+    vector<char> buffer(blockSize + 64);
+    size_t carried = 0;                 // Bytes of an unfinished number at the front
+    bool atEnd = false;
+
+    while (!atEnd)
+    {
+        if (carried >= 64)              // no integer is that long
+            return false;
+
+        size_t bytesRead = fread(buffer.data() + carried, 1, blockSize, in);
+        if (bytesRead < blockSize)
+        {
+            if (ferror(in))
+                return false;
+            atEnd = true;
+        }
+
+        const char *p = buffer.data();
+        const char *end = p + carried + bytesRead;
+
+        carried = 0;
+        while (p < end)
+        {
+            while (p < end && isNumberSpace(*p))
+                p++;
+            if (p == end)
+                break;
+
+            const char *tokenEnd = p;
+            while (tokenEnd < end && !isNumberSpace(*tokenEnd))
+                tokenEnd++;
+            if (tokenEnd == end && !atEnd)
+            {
+                // The number may continue in the next block.
+                carried = end - p;
+                memmove(buffer.data(), p, carried);
+                break;
+            }
+
+            intType value;
+            from_chars_result result = from_chars(p, tokenEnd, value);
+            if (result.ec != errc() || result.ptr != tokenEnd)
+                return false;
+            numbers.push_back(value);
+            p = tokenEnd;
+        }
+    }
+    return true;
+}
+
+template <class intType>
+bool readNumbers(const char* fileName, vector<intType>& numbers)
+{
+    FILE *in = fopen(fileName, "rb");
+    bool success;
+
+    if (in == nullptr)
+        return false;
+    success = readNumbers(in, numbers);
+    fclose(in);
+    return success;
+}
+
+#endif
@@ -0,0 +1,538 @@
+#ifndef PERSISTENTTREETYPE_H
+#define PERSISTENTTREETYPE_H
+
+/* An AVL tree whose versions share their nodes.
+    1. snapshot() (or the copy constructor) returns a tree that shares
+    the root of this one, which takes O(1) time and no memory for the
+    nodes; the snapshot does not change when this tree does.
+    2. Every node counts the links and trees that point to it. A node
+    counted once belongs to a single tree and is changed in place; a
+    shared node is copied first (path copying), so insert and
+    deleteNode copy at most the O(log n) nodes on their path, and only
+    while some snapshot still shares them.
+    3. The counts are atomic, so snapshots can be searched, traversed
+    and destroyed on other threads. One tree object (including
+    snapshot() of it) must still not be used by several threads while
+    one of them inserts or deletes.
+    4. A node is deleted when the last link or tree pointing to it goes
+    away; destroying a tree frees only the nodes no snapshot shares.
+*/
+
+#include <atomic>
+#include <functional>
+#include <utility>
+#include <vector>
+#include "treeCompare.h"
+#include "treeDiagnostics.h"
+
+using namespace std;
+
+// Definition of the node
+template <class elemType>
+struct persistentNodeType
+{
+    elemType info;                              // Store the data
+    persistentNodeType<elemType> *lLink;        // Pointer to the left child
+    persistentNodeType<elemType> *rLink;        // Pointer to the right child
+    int height;                                 // Height of the subtree
+    int size;                                   // Number of nodes in the subtree
+    atomic<int> refCount;                       // Links and trees pointing here
+
+    persistentNodeType(const elemType& item, persistentNodeType<elemType> *left,
+                       persistentNodeType<elemType> *right, int h, int s)
+        : info(item), lLink(left), rLink(right), height(h), size(s), refCount(1) {}
+};
+
+template <class elemType, class compareType = less<elemType> >
+class persistentTreeType
+{
+public:
+    bool search(const elemType& searchItem) const;
+    //Function to determine if searchItem is in the tree.
+    //Postcondition: Returns true if searchItem is found;
+    // otherwise, returns false. Searching an empty
+    // tree reports the searchEmptyTree event.
+
+    bool insert(const elemType& insertItem);
+    //Function to insert insertItem in the tree.
+    //Postcondition: If insertItem is not in the tree, it is
+    // inserted, the shared nodes on its path are
+    // copied and true is returned; otherwise,
+    // insertDuplicate is reported and false is
+    // returned. No snapshot changes.
+
+    bool deleteNode(const elemType& deleteItem);
+    //Function to delete deleteItem from the tree.
+    //Postcondition: If deleteItem is in the tree, it is
+    // deleted, the shared nodes on its path are
+    // copied and true is returned; otherwise,
+    // deleteEmptyTree or deleteNotFound is reported
+    // and false is returned. No snapshot changes.
+
+    persistentTreeType<elemType, compareType> snapshot() const;
+    //Function to take a read-only view of the tree as it is now.
+    //Takes O(1) time.
+    //Postcondition: Returns a tree sharing every node of this
+    // one; later changes to either tree do not
+    // show in the other.
+
+    template <class visitor>
+    void inorderTraversal(visitor&& visit) const;
+    //Function to visit the items in inorder sequence with a
+    //callable object taking a const elemType&.
+
+    bool isEmpty() const;
+    int treeNodeCount() const;
+    int treeHeight() const;
+    //Postcondition: Return whether the tree is empty, the
+    // number of nodes and the height of the tree.
+
+    void destroyTree();
+    //Postcondition: The tree is empty; the nodes shared with
+    // no snapshot are deallocated.
+
+    persistentTreeType(const persistentTreeType<elemType, compareType>& otherTree);
+    //Copy constructor; the same as otherTree.snapshot().
+
+    persistentTreeType(persistentTreeType<elemType, compareType>&& otherTree) noexcept;
+    //Move constructor
+
+    const persistentTreeType<elemType, compareType>& operator=
+                (const persistentTreeType<elemType, compareType>& otherTree);
+    persistentTreeType<elemType, compareType>& operator=
+                (persistentTreeType<elemType, compareType>&& otherTree) noexcept;
+    //Overload the assignment operators; the copy shares the
+    //nodes of otherTree.
+
+    explicit persistentTreeType(const compareType& compare);
+    //Constructor of an empty tree ordered by compare.
+
+    persistentTreeType();
+    //Default constructor
+
+    ~persistentTreeType();
+    //Destructor
+
+private:
+    typedef persistentNodeType<elemType> node;
+
+    static node* retain(node *p);
+    //Postcondition: The count of p (if any) is one larger;
+    // returns p.
+
+    static void release(node *p);
+    //Function to drop one link or tree pointing to p.
+    //Postcondition: p and, in turn, every node only it pointed
+    // to are deallocated if no link is left.
+
+    static node* unshare(node *p);
+    //Function to get a node that can be changed in place for
+    //the link that points to p.
+    //Postcondition: Returns p if the link is its only owner;
+    // otherwise, a copy of p owned by the link,
+    // with p's count one smaller.
+
+    static int nodeHeight(node *p);
+    static int nodeSize(node *p);
+    static void updateNode(node *p);
+    //Postcondition: p->height and p->size are recomputed from
+    // its subtrees.
+
+    static void rotateToLeft(node* &root);
+    static void rotateToRight(node* &root);
+    static void balance(node* &root);
+    //AVL rotations of avlTreeType; root and the children they
+    //move are unshared first.
+
+    void insertIntoTree(node* &p, const elemType& insertItem);
+    //Function to insert insertItem, known not to be in the
+    //tree, below the unshared node p.
+    //Postcondition: Every node on the path is rebalanced.
+
+    void deleteFromTree(node* &p, const elemType& deleteItem);
+    //Function to delete deleteItem, known to be in the tree,
+    //from the tree to which the unshared p points.
+    //Postcondition: Every node on the path is rebalanced.
+
+    static node* detachMax(node* &p);
+    //Function to unlink the node with the largest info from the
+    //nonempty tree to which the unshared p points.
+    //Postcondition: Returns the unlinked, unshared node.
+
+    node *root;                         // Pointer to the root node
+    compareType comp;                   // Order of the keys
+};
+
+template <class elemType, class compareType>
+persistentTreeType<elemType, compareType>::persistentTreeType()
+    : root(nullptr)
+{
+}
+
+template <class elemType, class compareType>
+persistentTreeType<elemType, compareType>::persistentTreeType(const compareType& compare)
+    : root(nullptr), comp(compare)
+{
+}
+
+template <class elemType, class compareType>
+persistentTreeType<elemType, compareType>::persistentTreeType
+                (const persistentTreeType<elemType, compareType>& otherTree)
+    : root(retain(otherTree.root)), comp(otherTree.comp)
+{
+}
+
+template <class elemType, class compareType>
+persistentTreeType<elemType, compareType>::persistentTreeType
+                (persistentTreeType<elemType, compareType>&& otherTree) noexcept
+    : root(otherTree.root), comp(otherTree.comp)
+{
+    otherTree.root = nullptr;
+}
+
+template <class elemType, class compareType>
+const persistentTreeType<elemType, compareType>& persistentTreeType<elemType, compareType>::operator=
+                (const persistentTreeType<elemType, compareType>& otherTree)
+{
+    node *oldRoot = root;
+
+    root = retain(otherTree.root);      // retain first: otherTree may
+    comp = otherTree.comp;              // be this tree
+    release(oldRoot);
+    return *this;
+}
+
+template <class elemType, class compareType>
+persistentTreeType<elemType, compareType>& persistentTreeType<elemType, compareType>::operator=
+                (persistentTreeType<elemType, compareType>&& otherTree) noexcept
+{
+    if (this != &otherTree)
+    {
+        release(root);
+        root = otherTree.root;
+        comp = otherTree.comp;
+        otherTree.root = nullptr;
+    }
+    return *this;
+}
+
+template <class elemType, class compareType>
+persistentTreeType<elemType, compareType>::~persistentTreeType()
+{
+    release(root);
+}
+
+template <class elemType, class compareType>
+persistentTreeType<elemType, compareType> persistentTreeType<elemType, compareType>::snapshot() const
+{
+    return *this;
+}
+
+template <class elemType, class compareType>
+bool persistentTreeType<elemType, compareType>::isEmpty() const
+{
+    return (root == nullptr);
+}
+
+template <class elemType, class compareType>
+int persistentTreeType<elemType, compareType>::treeNodeCount() const
+{
+    return nodeSize(root);
+}
+
+template <class elemType, class compareType>
+int persistentTreeType<elemType, compareType>::treeHeight() const
+{
+    return nodeHeight(root);
+}
+
+template <class elemType, class compareType>
+void persistentTreeType<elemType, compareType>::destroyTree()
+{
+    release(root);
+    root = nullptr;
+}
+
+template <class elemType, class compareType>
+persistentNodeType<elemType>* persistentTreeType<elemType, compareType>::retain(node *p)
+{
+    if (p != nullptr)
+        p->refCount.fetch_add(1, memory_order_relaxed);
+    return p;
+}
+
+template <class elemType, class compareType>
+void persistentTreeType<elemType, compareType>::release(node *p)
+// The nodes freed are collected on a stack instead of recursing, so
+// releasing a large tree needs no deep call stack. The acq_rel
+// decrement makes every change to a node happen before it is freed.
+{
+    vector<node*> stack;
+
+    if (p != nullptr)
+        stack.push_back(p);
+    while (!stack.empty())
+    {
+        p = stack.back();
+        stack.pop_back();
+        if (p->refCount.fetch_sub(1, memory_order_acq_rel) != 1)
+            continue;
+        if (p->lLink != nullptr)
+            stack.push_back(p->lLink);
+        if (p->rLink != nullptr)
+            stack.push_back(p->rLink);
+        delete p;
+    }
+} //end release
+
+template <class elemType, class compareType>
+persistentNodeType<elemType>* persistentTreeType<elemType, compareType>::unshare(node *p)
+// A count of 1 cannot grow behind our back: only the owner of that
+// single link could add another.
+{
+    node *copy;
+
+    if (p == nullptr || p->refCount.load(memory_order_acquire) == 1)
+        return p;
+
+    copy = new node(p->info, retain(p->lLink), retain(p->rLink), p->height, p->size);
+    release(p);
+    return copy;
+} //end unshare
+
+template <class elemType, class compareType>
+int persistentTreeType<elemType, compareType>::nodeHeight(node *p)
+{
+    if (p == nullptr)
+        return 0;
+    else
+        return p->height;
+}
+
+template <class elemType, class compareType>
+int persistentTreeType<elemType, compareType>::nodeSize(node *p)
+{
+    if (p == nullptr)
+        return 0;
+    else
+        return p->size;
+}
+
+template <class elemType, class compareType>
+void persistentTreeType<elemType, compareType>::updateNode(node *p)
+{
+    int lHeight = nodeHeight(p->lLink);
+    int rHeight = nodeHeight(p->rLink);
+
+    p->height = 1 + (lHeight >= rHeight ? lHeight : rHeight);
+    p->size = 1 + nodeSize(p->lLink) + nodeSize(p->rLink);
+}
+
+template <class elemType, class compareType>
+void persistentTreeType<elemType, compareType>::rotateToLeft(node* &root)
+// Links are moved, not duplicated, so no count changes.
+{
+    node *p = root->rLink = unshare(root->rLink);
+
+    root->rLink = p->lLink;
+    p->lLink = root;
+    updateNode(root);
+    updateNode(p);
+    root = p;
+} //end rotateToLeft
+
+template <class elemType, class compareType>
+void persistentTreeType<elemType, compareType>::rotateToRight(node* &root)
+{
+    node *p = root->lLink = unshare(root->lLink);
+
+    root->lLink = p->rLink;
+    p->rLink = root;
+    updateNode(root);
+    updateNode(p);
+    root = p;
+} //end rotateToRight
+
+template <class elemType, class compareType>
+void persistentTreeType<elemType, compareType>::balance(node* &root)
+{
+    int bFactor = nodeHeight(root->lLink) - nodeHeight(root->rLink);
+
+    if (bFactor > 1)
+    {
+        if (nodeHeight(root->lLink->lLink) < nodeHeight(root->lLink->rLink))
+        {
+            root->lLink = unshare(root->lLink);
+            rotateToLeft(root->lLink);
+        }
+        rotateToRight(root);
+    }
+    else if (bFactor < -1)
+    {
+        if (nodeHeight(root->rLink->rLink) < nodeHeight(root->rLink->lLink))
+        {
+            root->rLink = unshare(root->rLink);
+            rotateToRight(root->rLink);
+        }
+        rotateToLeft(root);
+    }
+    else
+        updateNode(root);
+} //end balance
+
+template <class elemType, class compareType>
+bool persistentTreeType<elemType, compareType>::search(const elemType& searchItem) const
+{
+    node *current = root;
+    int order;
+
+    if (root == nullptr)
+        reportTreeEvent(searchEmptyTree);
+    while (current != nullptr)
+    {
+        order = treeCompare(comp, current->info, searchItem);
+        if (order == 0)
+            return true;
+        else if (order > 0)
+            current = current->lLink;
+        else
+            current = current->rLink;
+    }
+    return false;
+} //end search
+
+template <class elemType, class compareType>
+void persistentTreeType<elemType, compareType>::insertIntoTree(node* &p, const elemType& insertItem)
+{
+    node* *link;
+
+    if (treeCompare(comp, p->info, insertItem) > 0)
+        link = &p->lLink;
+    else
+        link = &p->rLink;
+
+    if (*link == nullptr)
+        *link = new node(insertItem, nullptr, nullptr, 1, 1);
+    else
+    {
+        *link = unshare(*link);
+        insertIntoTree(*link, insertItem);
+    }
+    balance(p);
+} //end insertIntoTree
+
+template <class elemType, class compareType>
+bool persistentTreeType<elemType, compareType>::insert(const elemType& insertItem)
+// Searching first means a duplicate copies no node.
+{
+    if (search(insertItem))
+    {
+        reportTreeEvent(insertDuplicate);
+        return false;
+    }
+    if (root == nullptr)
+        root = new node(insertItem, nullptr, nullptr, 1, 1);
+    else
+    {
+        root = unshare(root);
+        insertIntoTree(root, insertItem);
+    }
+    return true;
+} //end insert
+
+template <class elemType, class compareType>
+persistentNodeType<elemType>* persistentTreeType<elemType, compareType>::detachMax(node* &p)
+{
+    node *maxNode;
+
+    if (p->rLink == nullptr)
+    {
+        maxNode = p;
+        p = p->lLink;               // the link moves from maxNode to p
+        maxNode->lLink = nullptr;
+        return maxNode;
+    }
+
+    p->rLink = unshare(p->rLink);
+    maxNode = detachMax(p->rLink);
+    balance(p);
+    return maxNode;
+} //end detachMax
+
+template <class elemType, class compareType>
+void persistentTreeType<elemType, compareType>::deleteFromTree(node* &p, const elemType& deleteItem)
+{
+    node *temp;
+    int order = treeCompare(comp, p->info, deleteItem);
+
+    if (order > 0)
+    {
+        p->lLink = unshare(p->lLink);
+        deleteFromTree(p->lLink, deleteItem);
+    }
+    else if (order < 0)
+    {
+        p->rLink = unshare(p->rLink);
+        deleteFromTree(p->rLink, deleteItem);
+    }
+    else if (p->lLink != nullptr && p->rLink != nullptr)
+    {
+        // Two children: move the info of the inorder predecessor,
+        // which only this tree owns after unshare, into p.
+        p->lLink = unshare(p->lLink);
+        temp = detachMax(p->lLink);
+        p->info = std::move(temp->info);
+        release(temp);
+    }
+    else
+    {
+        temp = p;
+        p = (p->lLink == nullptr) ? temp->rLink : temp->lLink;
+        temp->lLink = nullptr;      // its child link moved to p
+        temp->rLink = nullptr;
+        release(temp);
+        return;
+    }
+    balance(p);
+} //end deleteFromTree
+
+template <class elemType, class compareType>
+bool persistentTreeType<elemType, compareType>::deleteNode(const elemType& deleteItem)
+{
+    if (root == nullptr)
+    {
+        reportTreeEvent(deleteEmptyTree);
+        return false;
+    }
+    if (!search(deleteItem))
+    {
+        reportTreeEvent(deleteNotFound);
+        return false;
+    }
+    root = unshare(root);
+    deleteFromTree(root, deleteItem);
+    return true;
+} //end deleteNode
+
+template <class elemType, class compareType>
+template <class visitor>
+void persistentTreeType<elemType, compareType>::inorderTraversal(visitor&& visit) const
+{
+    vector<node*> stack;
+    node *p = root;
+
+    while (p != nullptr || !stack.empty())
+    {
+        while (p != nullptr)
+        {
+            stack.push_back(p);
+            p = p->lLink;
+        }
+        p = stack.back();
+        stack.pop_back();
+        visit(static_cast<const elemType&>(p->info));
+        p = p->rLink;
+    }
+} //end inorderTraversal
+
+#endif
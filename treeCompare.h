@@ -0,0 +1,77 @@
+// Three-way comparison for the search trees.
+// The trees take a comparator (less<elemType> by default) and each
+// level of a search asks it once for the order of the item and the
+// node, as a value less than, equal to or greater than 0, instead of
+// testing == and then >. treeCompare(comp, a, b) uses
+//      comp.compare(a, b) if the comparator has such a member,
+//      a single test for less<> and less<T> on arithmetic types and
+//      a single compare() for them on strings (string and
+//      string_view, or one of them and a C string; two pointers are
+//      left to the comparator, which orders them by address),
+//      comp(a, b) and then comp(b, a) otherwise.
+// A comparator with a member type is_transparent, such as less<>,
+// also lets the trees look up keys of another type than elemType
+// (e.g. string_view in a tree of string) without building an
+// elemType.
+#ifndef TREECOMPARE_H
+#define TREECOMPARE_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+using namespace std;
+
+template <class compareType, class leftType, class rightType, class = void>
+struct hasThreeWayCompare : false_type {};
+
+template <class compareType, class leftType, class rightType>
+struct hasThreeWayCompare<compareType, leftType, rightType,
+        void_t<decltype(declval<const compareType&>().compare(declval<const leftType&>(),
+                                                               declval<const rightType&>()))> >
+    : true_type {};
+
+template <class compareType>
+struct isNaturalOrder : false_type {};  // The comparator is less<>
+                                        // or less<T>
+template <class T>
+struct isNaturalOrder<less<T> > : true_type {};
+
+template <class T>
+struct isStringKey : false_type {};     // T is a string class
+
+template <> struct isStringKey<string> : true_type {};
+template <> struct isStringKey<string_view> : true_type {};
+
+template <class T>
+struct isCStringKey : false_type {};    // T is a C string
+
+template <> struct isCStringKey<const char*> : true_type {};
+template <> struct isCStringKey<char*> : true_type {};
+template <size_t n> struct isCStringKey<char[n]> : true_type {};
+template <size_t n> struct isCStringKey<const char[n]> : true_type {};
+
+template <class leftType, class rightType>
+struct isStringPair                     // Both are strings and at least
+    : integral_constant<bool,           // one is a string class
+        (isStringKey<leftType>::value && (isStringKey<rightType>::value || isCStringKey<rightType>::value))
+        || (isCStringKey<leftType>::value && isStringKey<rightType>::value)> {};
+
+template <class compareType, class leftType, class rightType>
+inline int treeCompare(const compareType& comp, const leftType& a, const rightType& b)
+{
+    if constexpr (hasThreeWayCompare<compareType, leftType, rightType>::value)
+        return comp.compare(a, b);
+    else if constexpr (isNaturalOrder<compareType>::value && is_arithmetic<leftType>::value
+                       && is_same<leftType, rightType>::value)
+        return (b < a) - (a < b);
+    else if constexpr (isNaturalOrder<compareType>::value && isStringPair<leftType, rightType>::value)
+        return string_view(a).compare(string_view(b));
+    else
+        return comp(a, b) ? -1 : (comp(b, a) ? 1 : 0);
+} //end treeCompare
+
+#endif
@@ -0,0 +1,64 @@
+// Diagnostics of the trees.
+// The trees do no console I/O of their own: insert and deleteNode
+// return whether they changed the tree, and the unusual cases (a
+// duplicate insert, a delete or search that finds nothing to work on)
+// are reported through one process-wide hook. No hook is installed by
+// default, so reporting an event costs a single test of a pointer.
+//      setTreeDiagnostic(hook)     installs hook; nullptr removes it
+//      treeEventMessage(event)     the message the trees used to print
+#ifndef TREEDIAGNOSTICS_H
+#define TREEDIAGNOSTICS_H
+
+using namespace std;
+
+enum treeEvent
+{
+    searchEmptyTree,            // search called on an empty tree
+    insertDuplicate,            // insert found the item already in the tree
+    deleteEmptyTree,            // deleteNode called on an empty tree
+    deleteNotFound              // deleteNode did not find the item
+};
+
+typedef void (*treeDiagnostic)(treeEvent event);
+
+inline treeDiagnostic& treeDiagnosticHook()
+{
+    static treeDiagnostic hook = nullptr;
+
+    return hook;
+}
+
+inline void setTreeDiagnostic(treeDiagnostic hook)
+//Function to install the diagnostic hook. Not synchronized; install
+//the hook before the trees are used by other threads.
+//Postcondition: hook is called for every event reported from now on.
+{
+    treeDiagnosticHook() = hook;
+}
+
+inline void reportTreeEvent(treeEvent event)
+{
+    treeDiagnostic hook = treeDiagnosticHook();
+
+    if (hook != nullptr)
+        hook(event);
+}
+
+inline const char* treeEventMessage(treeEvent event)
+{
+    switch (event)
+    {
+    case searchEmptyTree:
+        return "Cannot search an empty tree.";
+    case insertDuplicate:
+        return "The item to be inserted is already in the tree -- "
+               "duplicates are not allowed.";
+    case deleteEmptyTree:
+        return "Cannot delete from an empty tree.";
+    case deleteNotFound:
+        return "The item to be deleted is not in the tree.";
+    }
+    return "";
+}
+
+#endif
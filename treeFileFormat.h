@@ -0,0 +1,78 @@
+// Binary file format of a saved search tree (see saveTree and loadTree
+// of bSearchTreeType and mappedSearchTreeType).
+// The file is a header followed by the items as raw bytes, in
+// increasing order of the comparator of the tree that saved them
+// (ascending for the default less<elemType>), so it can only hold
+// trivially copyable items, is only read back on a machine with the
+// same byte order and item layout, and must be read with the same
+// comparator:
+//      magic       8 bytes, "BSTREE" 0 1
+//      version     uint32_t, treeFileVersion
+//      itemSize    uint32_t, sizeof(elemType)
+//      count       uint64_t, number of items
+//      checksum    uint64_t, treeChecksum of the items
+//      items       count * itemSize bytes, starting at byte 32
+// Keeping the items sorted makes the file both a compact encoding for
+// a balanced rebuild and a sorted array that can be searched in place.
+#ifndef TREEFILEFORMAT_H
+#define TREEFILEFORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+using namespace std;
+
+const char treeFileMagic[8] = {'B', 'S', 'T', 'R', 'E', 'E', 0, 1};
+const uint32_t treeFileVersion = 1;
+
+struct treeFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t itemSize;
+    uint64_t count;
+    uint64_t checksum;
+};
+
+static_assert(sizeof(treeFileHeader) == 32, "treeFileHeader must have no padding");
+
+const uint64_t treeChecksumSeed = 0xcbf29ce484222325ULL;
+
+inline uint64_t treeChecksum(const void *data, size_t bytes, uint64_t hash = treeChecksumSeed)
+//Function to fold bytes bytes of data into hash, eight bytes at a
+//time. A checksum computed piecewise equals the one of the whole when
+//every piece but the last is a multiple of 8 bytes long.
+//Postcondition: Returns the updated hash.
+{
+    const unsigned char *p = static_cast<const unsigned char*>(data);
+    uint64_t word;
+
+    while (bytes >= 8)
+    {
+        memcpy(&word, p, 8);
+        hash = (hash ^ word) * 0x100000001b3ULL;
+        hash ^= hash >> 29;
+        p += 8;
+        bytes -= 8;
+    }
+    while (bytes > 0)
+    {
+        hash = (hash ^ *p) * 0x100000001b3ULL;
+        p++;
+        bytes--;
+    }
+    return hash;
+}
+
+inline bool validTreeHeader(const treeFileHeader& header, size_t itemSize)
+//Postcondition: Returns true if header has the magic, the version and
+// the item size of a file holding items of itemSize
+// bytes.
+{
+    return (memcmp(header.magic, treeFileMagic, sizeof(treeFileMagic)) == 0
+            && header.version == treeFileVersion
+            && header.itemSize == itemSize);
+}
+
+#endif
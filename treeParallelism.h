@@ -0,0 +1,102 @@
+// Settings and worker threads for the parallel tree operations.
+// A large tree is cut into the subtrees of at most cutoff nodes that
+// hang below the nodes with more than cutoff nodes (the subtree sizes
+// stored in the nodes make this a walk over the top of the tree only).
+// The subtrees are tasks; the workers keep taking the next task nobody
+// has taken yet, so a worker that finishes early helps with the rest
+// instead of waiting. Trees with at most cutoff nodes, or a thread
+// count of 1, are handled by the serial code.
+//      setTreeParallelism(threads, cutoff)
+//                  threads == 0 means one per hardware thread
+//      parallelFor(count, threads, task)
+//                  calls task(i) for i = 0..count-1 on up to threads
+//                  threads, the caller included
+#ifndef TREEPARALLELISM_H
+#define TREEPARALLELISM_H
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+struct treeParallelism
+{
+    unsigned threads;               // Number of threads, the caller included
+    int cutoff;                     // Largest subtree handled by one task
+};
+
+inline treeParallelism& treeParallelismSettings()
+{
+    static treeParallelism settings = {0, 1 << 15};
+
+    return settings;
+}
+
+inline void setTreeParallelism(unsigned threads, int cutoff)
+//Function to set the thread count and the cutoff of the parallel
+//tree operations. Not synchronized; call it before the trees are
+//used by other threads.
+//Postcondition: The parallel operations use up to threads threads
+// (one per hardware thread if threads is 0) and
+// tasks of at most cutoff nodes.
+{
+    treeParallelismSettings().threads = threads;
+    treeParallelismSettings().cutoff = (cutoff > 0 ? cutoff : 1);
+}
+
+inline unsigned treeThreadCount()
+//Postcondition: Returns the number of threads to use, at least 1.
+{
+    unsigned threads = treeParallelismSettings().threads;
+
+    if (threads == 0)
+        threads = thread::hardware_concurrency();
+    return (threads == 0 ? 1 : threads);
+}
+
+template <class taskType>
+void parallelFor(size_t count, unsigned threads, taskType& task)
+// If a task throws, the workers stop taking new tasks and the first
+// exception is rethrown in the caller once every worker has finished.
+{
+    atomic<size_t> next(0);
+    exception_ptr failure;
+    mutex failureLock;
+    vector<thread> workers;
+
+    auto work = [&]()
+    {
+        size_t i;
+
+        while ((i = next.fetch_add(1, memory_order_relaxed)) < count)
+        {
+            try
+            {
+                task(i);
+            }
+            catch (...)
+            {
+                lock_guard<mutex> lock(failureLock);
+                if (!failure)
+                    failure = current_exception();
+                next.store(count, memory_order_relaxed);
+            }
+        }
+    };
+
+    if (threads > count)
+        threads = (unsigned)count;
+    for (unsigned t = 1; t < threads; t++)
+        workers.push_back(thread(work));
+    work();
+    for (size_t t = 0; t < workers.size(); t++)
+        workers[t].join();
+    if (failure)
+        rethrow_exception(failure);
+}
+
+#endif
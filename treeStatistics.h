@@ -0,0 +1,344 @@
+// Operation statistics and shape report of the trees.
+// The statistics are compiled in only when BINARYTREE_STATS is defined
+// (e.g. -DBINARYTREE_STATS); otherwise the TREE_STATS_* macros used by
+// the trees expand to nothing and the trees carry no extra members.
+// With statistics, every tree records for search, insert and
+// deleteNode
+//      calls and successes (found, inserted, deleted)
+//      a histogram of the key comparisons, one per node whose key was
+//      compared with the item
+//      a histogram of the depth reached, which for deleteNode also
+//      counts the walk down to the inorder predecessor
+//      a latency histogram with about 12% resolution, for percentiles
+// and its allocator counts the nodes it allocates and deallocates.
+// The recording is not synchronized: a tree built with statistics must
+// not be searched by several threads at once.
+// The shape report (treeShape) is always available.
+#ifndef TREESTATISTICS_H
+#define TREESTATISTICS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <vector>
+
+using namespace std;
+
+enum treeOperation { searchOperation, insertOperation, deleteOperation };
+const int treeOperationCount = 3;
+
+// Counts of small values; the last bucket also counts every larger value
+class valueHistogram
+{
+public:
+    static const size_t maxValue = 128;
+
+    void add(size_t value);
+    long long count(size_t value) const;
+    //Postcondition: Returns how many times value was added.
+
+    void writeJson(ostream& out) const;
+    //Postcondition: Writes {"value": count, ...} for the nonzero
+    // counts.
+
+    valueHistogram() : counts(maxValue + 1, 0) {}
+
+private:
+    vector<long long> counts;
+};
+
+// Latency histogram: exact below 16 ns, then 8 buckets per power of 2
+class latencyHistogram
+{
+public:
+    void add(uint64_t nanoseconds);
+    uint64_t percentile(double p) const;
+    //Postcondition: Returns an upper bound of the latency below
+    // which a fraction p of the samples lie, 0 if
+    // there are no samples.
+
+    void writeJson(ostream& out) const;
+    //Postcondition: Writes the mean, p50, p90, p99, p99.9 and max
+    // in nanoseconds.
+
+    latencyHistogram() : counts(bucketCount, 0), samples(0), total(0), largest(0) {}
+
+private:
+    static const size_t bucketCount = 16 + 60 * 8;
+
+    static size_t bucket(uint64_t nanoseconds);
+    static uint64_t bucketTop(size_t index);
+
+    vector<long long> counts;
+    long long samples;
+    uint64_t total;
+    uint64_t largest;
+};
+
+struct operationStatistics
+{
+    long long calls;
+    long long successes;
+    valueHistogram comparisons;
+    valueHistogram depth;
+    latencyHistogram latency;
+
+    operationStatistics() : calls(0), successes(0) {}
+};
+
+class treeStatistics
+{
+public:
+    typedef chrono::steady_clock::time_point timePoint;
+
+    timePoint begin();
+    //Function to start recording an operation.
+    //Postcondition: Returns the start time.
+
+    void visit() { currentComparisons++; currentDepth++; }
+    //Function to record a node whose key was compared.
+
+    void walk() { currentDepth++; }
+    //Function to record a node passed without a key comparison.
+
+    void compare() { currentComparisons++; }
+    //Function to record a key comparison at a node already
+    //counted, e.g. when the path is walked a second time.
+
+    void end(treeOperation operation, timePoint start, bool success);
+    //Function to finish recording the operation started at start.
+
+    const operationStatistics& operation(treeOperation operation) const;
+    //Postcondition: Returns the statistics of operation.
+
+    void reset();
+    //Postcondition: Every statistic is zero.
+
+    void writeJson(ostream& out) const;
+    //Postcondition: Writes the statistics of each operation.
+
+    treeStatistics() : currentComparisons(0), currentDepth(0) {}
+
+private:
+    operationStatistics operations[treeOperationCount];
+    size_t currentComparisons;
+    size_t currentDepth;
+};
+
+// Node counts of an allocator; copies take the counts along
+class allocationCounter
+{
+public:
+    void allocated() { allocations.fetch_add(1, memory_order_relaxed); }
+    void deallocated() { deallocations.fetch_add(1, memory_order_relaxed); }
+    void releasedAll() { deallocations.store(allocationCount(), memory_order_relaxed); }
+    long long allocationCount() const { return allocations.load(memory_order_relaxed); }
+    long long deallocationCount() const { return deallocations.load(memory_order_relaxed); }
+
+    allocationCounter() : allocations(0), deallocations(0) {}
+    allocationCounter(const allocationCounter& other)
+        : allocations(other.allocationCount()), deallocations(other.deallocationCount()) {}
+    allocationCounter& operator=(const allocationCounter& other)
+    {
+        allocations.store(other.allocationCount(), memory_order_relaxed);
+        deallocations.store(other.deallocationCount(), memory_order_relaxed);
+        return *this;
+    }
+
+private:
+    atomic<long long> allocations;      // Atomic for the parallel copy
+    atomic<long long> deallocations;    // and destroy
+};
+
+// Shape of a binary tree
+struct treeShape
+{
+    int nodeCount;
+    int height;
+    int optimalHeight;                  // Smallest height for nodeCount nodes
+    int leaves;
+    map<int, long long> balanceFactors; // Height of the left subtree minus the
+                                        // height of the right one -> nodes
+
+    void writeJson(ostream& out) const;
+    //Postcondition: Writes the shape, with the ratio of height to
+    // optimalHeight.
+
+    treeShape() : nodeCount(0), height(0), optimalHeight(0), leaves(0) {}
+};
+
+#ifdef BINARYTREE_STATS
+#define TREE_STATS_BEGIN() treeStatistics::timePoint treeStatsStart = this->stats.begin()
+#define TREE_STATS_END(operation, success) this->stats.end(operation, treeStatsStart, success)
+#define TREE_STATS_VISIT() this->stats.visit()
+#define TREE_STATS_WALK() this->stats.walk()
+#define TREE_STATS_COMPARE() this->stats.compare()
+#else
+#define TREE_STATS_BEGIN()
+#define TREE_STATS_END(operation, success)
+#define TREE_STATS_VISIT() ((void)0)
+#define TREE_STATS_WALK() ((void)0)
+#define TREE_STATS_COMPARE() ((void)0)
+#endif
+
+inline void valueHistogram::add(size_t value)
+{
+    counts[value < maxValue ? value : maxValue]++;
+}
+
+inline long long valueHistogram::count(size_t value) const
+{
+    return counts[value < maxValue ? value : maxValue];
+}
+
+inline void valueHistogram::writeJson(ostream& out) const
+{
+    bool first = true;
+
+    out << "{";
+    for (size_t i = 0; i <= maxValue; i++)
+    {
+        if (counts[i] == 0)
+            continue;
+        out << (first ? "" : ", ") << "\"" << i << (i == maxValue ? "+" : "") << "\": " << counts[i];
+        first = false;
+    }
+    out << "}";
+}
+
+inline size_t latencyHistogram::bucket(uint64_t nanoseconds)
+// Below 16 every value has a bucket; above, the 8 buckets of
+// [2^e, 2^(e+1)) are told apart by the 3 bits after the leading one.
+{
+    int e = 4;
+
+    if (nanoseconds < 16)
+        return static_cast<size_t>(nanoseconds);
+    while (e < 63 && (nanoseconds >> (e + 1)) != 0)
+        e++;
+    return 16 + (e - 4) * 8 + static_cast<size_t>((nanoseconds >> (e - 3)) & 7);
+}
+
+inline uint64_t latencyHistogram::bucketTop(size_t index)
+{
+    if (index < 16)
+        return index;
+
+    int e = static_cast<int>((index - 16) / 8) + 4;
+    uint64_t sub = (index - 16) % 8;
+
+    return ((8 + sub + 1) << (e - 3)) - 1;
+}
+
+inline void latencyHistogram::add(uint64_t nanoseconds)
+{
+    counts[bucket(nanoseconds)]++;
+    samples++;
+    total += nanoseconds;
+    if (nanoseconds > largest)
+        largest = nanoseconds;
+}
+
+inline uint64_t latencyHistogram::percentile(double p) const
+{
+    long long rank = static_cast<long long>(p * samples);
+    long long seen = 0;
+
+    if (samples == 0)
+        return 0;
+    if (rank >= samples)
+        rank = samples - 1;
+    for (size_t i = 0; i < counts.size(); i++)
+    {
+        seen += counts[i];
+        if (seen > rank)
+            return (bucketTop(i) < largest ? bucketTop(i) : largest);
+    }
+    return largest;
+}
+
+inline void latencyHistogram::writeJson(ostream& out) const
+{
+    out << "{\"mean\": " << (samples > 0 ? static_cast<double>(total) / samples : 0.0)
+        << ", \"p50\": " << percentile(0.5)
+        << ", \"p90\": " << percentile(0.9)
+        << ", \"p99\": " << percentile(0.99)
+        << ", \"p99.9\": " << percentile(0.999)
+        << ", \"max\": " << largest << "}";
+}
+
+inline treeStatistics::timePoint treeStatistics::begin()
+{
+    currentComparisons = 0;
+    currentDepth = 0;
+    return chrono::steady_clock::now();
+}
+
+inline void treeStatistics::end(treeOperation operation, timePoint start, bool success)
+{
+    operationStatistics& stats = operations[operation];
+    chrono::nanoseconds elapsed = chrono::steady_clock::now() - start;
+
+    stats.calls++;
+    if (success)
+        stats.successes++;
+    stats.comparisons.add(currentComparisons);
+    stats.depth.add(currentDepth);
+    stats.latency.add(static_cast<uint64_t>(elapsed.count()));
+}
+
+inline const operationStatistics& treeStatistics::operation(treeOperation operation) const
+{
+    return operations[operation];
+}
+
+inline void treeStatistics::reset()
+{
+    for (int i = 0; i < treeOperationCount; i++)
+        operations[i] = operationStatistics();
+    currentComparisons = 0;
+    currentDepth = 0;
+}
+
+inline void treeStatistics::writeJson(ostream& out) const
+{
+    const char* const names[treeOperationCount] = {"search", "insert", "deleteNode"};
+
+    out << "{";
+    for (int i = 0; i < treeOperationCount; i++)
+    {
+        const operationStatistics& stats = operations[i];
+
+        out << (i == 0 ? "" : ", ") << "\"" << names[i] << "\": {"
+            << "\"calls\": " << stats.calls << ", \"successes\": " << stats.successes
+            << ", \"comparisons\": ";
+        stats.comparisons.writeJson(out);
+        out << ", \"depth\": ";
+        stats.depth.writeJson(out);
+        out << ", \"latencyNs\": ";
+        stats.latency.writeJson(out);
+        out << "}";
+    }
+    out << "}";
+}
+
+inline void treeShape::writeJson(ostream& out) const
+{
+    bool first = true;
+
+    out << "{\"nodeCount\": " << nodeCount << ", \"height\": " << height
+        << ", \"optimalHeight\": " << optimalHeight
+        << ", \"heightRatio\": " << (optimalHeight > 0 ? static_cast<double>(height) / optimalHeight : 1.0)
+        << ", \"leaves\": " << leaves << ", \"balanceFactors\": {";
+    for (map<int, long long>::const_iterator it = balanceFactors.begin(); it != balanceFactors.end(); ++it)
+    {
+        out << (first ? "" : ", ") << "\"" << it->first << "\": " << it->second;
+        first = false;
+    }
+    out << "}}";
+}
+
+#endif